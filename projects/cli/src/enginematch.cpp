@@ -17,6 +17,7 @@
 
 #include "econode.h"
 #include "board/board.h"
+#include "board/syzygytablebase.h"
 
 #include "enginematch.h"
 #include <QtMath>
@@ -24,6 +25,7 @@
 #include <QMultiMap>
 #include <QTextCodec>
 #include <chessplayer.h>
+#include <chessengine.h>
 #include <playerbuilder.h>
 #include <chessgame.h>
 #include <polyglotbook.h>
@@ -829,6 +831,24 @@ void EngineMatch::onGameFinished(ChessGame* game, int number)
 	      qUtf8Printable(game->player(Chess::Side::Black)->name()),
 	      qUtf8Printable(result.toVerboseString()));
 
+	if (m_debug)
+	{
+		qInfo("Game %d harness CPU time per move: %.1f us",
+		      number, double(game->moveCpuTime()) / 1000.0);
+
+		for (int i = 0; i < 2; i++)
+		{
+			auto engine = qobject_cast<ChessEngine*>(
+				game->player(Chess::Side::Type(i)));
+			if (engine == nullptr)
+				continue;
+			qInfo("Engine %s: %llu writes, %llu bytes written",
+			      qUtf8Printable(engine->name()),
+			      engine->deviceWriteCount(),
+			      engine->deviceBytesWritten());
+		}
+	}
+
 	if (!m_tournamentFile.isEmpty()) {
 		QVariantMap tfMap;
 
@@ -948,6 +968,22 @@ void EngineMatch::onTournamentFinished()
 	if (!error.isEmpty())
 		qWarning("%s", qUtf8Printable(error));
 
+	const quint64 tbProbes = SyzygyTablebase::probeCount();
+	const quint64 tbCacheHits = SyzygyTablebase::cacheHitCount();
+	if (tbProbes + tbCacheHits > 0)
+		qInfo("Tablebase probes: %llu, cache hits: %llu, probe time: %.1f ms",
+		      tbProbes, tbCacheHits,
+		      double(SyzygyTablebase::probeTime()) / 1000000.0);
+
+	const auto tbStats = SyzygyTablebase::materialStatistics();
+	for (const auto& item : tbStats)
+	{
+		const quint64 probes = item.hits + item.misses;
+		qInfo("  %-10s hits: %llu, misses: %llu, avg latency: %.1f us",
+		      qUtf8Printable(item.material), item.hits, item.misses,
+		      double(item.probeTime) / 1000.0 / qMax(probes, quint64(1)));
+	}
+
 	qInfo("Finished match");
 	connect(m_tournament->gameManager(), SIGNAL(finished()),
 		this, SIGNAL(finished()));
@@ -46,6 +46,7 @@
 #include "cutechesscoreapp.h"
 #include "matchparser.h"
 #include "enginematch.h"
+#include "perft.h"
 
 namespace {
 
@@ -254,6 +255,10 @@ bool parseEngine(const QStringList& args, EngineData& data)
 		{
 			data.config.setWhiteEvalPov(true);
 		}
+		else if (name == "incrementalposition")
+		{
+			data.config.setIncrementalPosition(true);
+		}
 		else if (name == "depth")
 		{
 			if (val.toInt() <= 0)
@@ -306,6 +311,8 @@ EngineMatch* parseMatch(const QStringList& args, CuteChessCoreApplication& app)
 	parser.addOption("-tb", QVariant::String, 1, 1);
 	parser.addOption("-tbpieces", QVariant::Int, 1, 1);
 	parser.addOption("-tbignore50", QVariant::Bool, 0, 0);
+	parser.addOption("-tbwdl", QVariant::Bool, 0, 0);
+	parser.addOption("-tbpreload", QVariant::Bool, 0, 0);
 	parser.addOption("-event", QVariant::String, 1, 1);
 	parser.addOption("-games", QVariant::Int, 1, 1);
 	parser.addOption("-rounds", QVariant::Int, 1, 1);
@@ -342,6 +349,7 @@ EngineMatch* parseMatch(const QStringList& args, CuteChessCoreApplication& app)
 	bool wantsPgnFormat = true;
 	bool wantsJsonFormat = true;
 	bool wantsDebug = parser.takeOption("-debug").toBool();
+	bool wantsTbPreload = false;
 
 	QString ecoPgn = parser.takeOption("-ecopgn").toString();
 	if (!ecoPgn.isEmpty())
@@ -528,6 +536,10 @@ EngineMatch* parseMatch(const QStringList& args, CuteChessCoreApplication& app)
 		if (tMap.contains("tbIgnore50"))
 			if (tMap["tbIgnore50"].toBool())
 				SyzygyTablebase::setNoRule50();
+		if (tMap.contains("tbWdl"))
+			adjudicator.setTablebaseWdlAdjudication(tMap["tbWdl"].toBool());
+		if (tMap.contains("tbPreload"))
+			wantsTbPreload = tMap["tbPreload"].toBool();
 
 		if (tMap.contains("openings")) {
 			openingsOption.name = "-openings";
@@ -706,6 +718,19 @@ EngineMatch* parseMatch(const QStringList& args, CuteChessCoreApplication& app)
 					SyzygyTablebase::setNoRule50();
 				tMap.insert("tbIgnore50", flag);
 			}
+			// Syzygy WDL-only adjudication
+			else if (name == "-tbwdl")
+			{
+				bool flag = value.toBool();
+				adjudicator.setTablebaseWdlAdjudication(flag);
+				tMap.insert("tbWdl", flag);
+			}
+			// Preload Syzygy tablebase files
+			else if (name == "-tbpreload")
+			{
+				wantsTbPreload = value.toBool();
+				tMap.insert("tbPreload", wantsTbPreload);
+			}
 			// Event name
 			else if (name == "-event")
 			{
@@ -1055,9 +1080,55 @@ EngineMatch* parseMatch(const QStringList& args, CuteChessCoreApplication& app)
 
 	tournament->setAdjudicator(adjudicator);
 
+	// Start after all options are parsed so that -tbpieces is known
+	if (wantsTbPreload)
+		SyzygyTablebase::preload();
+
 	return match;
 }
 
+int runPerft(const QStringList& args)
+{
+	if (args.size() < 3)
+	{
+		qWarning("Usage: -perft VARIANT FEN DEPTH");
+		return 1;
+	}
+
+	const QString variant = args.at(0);
+	if (!Chess::BoardFactory::variants().contains(variant))
+	{
+		qWarning("Unknown variant: %s", qUtf8Printable(variant));
+		return 1;
+	}
+
+	bool ok = false;
+	int depth = args.at(2).toInt(&ok);
+	if (!ok || depth < 1 || depth > 64)
+	{
+		qWarning("Invalid perft depth: %s", qUtf8Printable(args.at(2)));
+		return 1;
+	}
+
+	Chess::Board* board = Chess::BoardFactory::create(variant);
+	QString fen = args.at(1);
+	if (fen == "startpos")
+		fen = board->defaultFenString();
+	if (!board->setFenString(fen))
+	{
+		qWarning("Invalid FEN string: %s", qUtf8Printable(fen));
+		delete board;
+		return 1;
+	}
+
+	QTextStream out(stdout);
+	Perft perft(board);
+	perft.divide(depth, out);
+	delete board;
+
+	return 0;
+}
+
 } // anonymous namespace
 
 int main(int argc, char* argv[])
@@ -1107,6 +1178,8 @@ int main(int argc, char* argv[])
 				out << file.readAll();
 			return 0;
 		}
+		else if (arg == "--perft" || arg == "-perft")
+			return runPerft(arguments.mid(arguments.indexOf(arg) + 1));
 	}
 
 	s_match = parseMatch(arguments, app);
@@ -0,0 +1,187 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "perft.h"
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <board/board.h>
+
+namespace {
+
+class PerftTask : public QRunnable
+{
+	public:
+		PerftTask(Perft* perft,
+			  Chess::Board* board,
+			  int depth,
+			  std::atomic<quint64>* nodes)
+			: m_perft(perft),
+			  m_board(board),
+			  m_depth(depth),
+			  m_nodes(nodes)
+		{
+		}
+
+		virtual ~PerftTask()
+		{
+			delete m_board;
+		}
+
+		virtual void run()
+		{
+			m_nodes->fetch_add(m_perft->perft(m_board, m_depth));
+		}
+
+	private:
+		Perft* m_perft;
+		Chess::Board* m_board;
+		int m_depth;
+		std::atomic<quint64>* m_nodes;
+};
+
+} // anonymous namespace
+
+Perft::Perft(const Chess::Board* board, int hashBits)
+	: m_board(board),
+	  m_hashMask((Q_UINT64_C(1) << hashBits) - 1),
+	  m_hash(new HashEntry[m_hashMask + 1]())
+{
+	Q_ASSERT(board != nullptr);
+}
+
+Perft::~Perft()
+{
+}
+
+bool Perft::probe(quint64 key, int depth, quint64* nodes) const
+{
+	// The entries are written without locking. An entry is only
+	// used if its check value matches the data, so a torn entry
+	// written by two threads at once is ignored.
+	const HashEntry& entry = m_hash[key & m_hashMask];
+	quint64 data = entry.data.load(std::memory_order_relaxed);
+	quint64 check = entry.check.load(std::memory_order_relaxed);
+
+	if ((check ^ data) != key || int(data & 0xFF) != depth)
+		return false;
+
+	*nodes = data >> 8;
+	return true;
+}
+
+void Perft::store(quint64 key, int depth, quint64 nodes)
+{
+	HashEntry& entry = m_hash[key & m_hashMask];
+	quint64 data = (nodes << 8) | quint64(depth);
+
+	entry.data.store(data, std::memory_order_relaxed);
+	entry.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+quint64 Perft::perft(Chess::Board* board, int depth)
+{
+	if (depth <= 0)
+		return 1;
+
+	Chess::MoveList moves;
+	if (depth == 1)
+	{
+		board->legalMoves(moves);
+		return moves.size();
+	}
+
+	quint64 key = board->key();
+	quint64 nodes = 0;
+	if (probe(key, depth, &nodes))
+		return nodes;
+
+	board->legalMoves(moves);
+	for (const Chess::Move& move : moves)
+	{
+		board->makeMove(move);
+		nodes += perft(board, depth - 1);
+		board->undoMove();
+	}
+
+	store(key, depth, nodes);
+	return nodes;
+}
+
+quint64 Perft::divide(int depth, QTextStream& out)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	Chess::Board* board = m_board->copy();
+	Chess::MoveList rootMoves;
+	board->legalMoves(rootMoves);
+
+	QStringList moveStrings;
+	QVector<std::atomic<quint64>*> rootNodes;
+	QThreadPool pool;
+	pool.setMaxThreadCount(QThread::idealThreadCount());
+
+	// Split the tree after two plies so that there are enough
+	// tasks to keep all the threads busy.
+	for (const Chess::Move& move : rootMoves)
+	{
+		moveStrings << board->moveString(move, Chess::Board::LongAlgebraic);
+		rootNodes << new std::atomic<quint64>(0);
+		if (depth <= 1)
+		{
+			rootNodes.last()->store(1);
+			continue;
+		}
+
+		board->makeMove(move);
+		Chess::MoveList replies;
+		board->legalMoves(replies);
+		for (const Chess::Move& reply : replies)
+		{
+			Chess::Board* tmp = board->copy();
+			tmp->makeMove(reply);
+			pool.start(new PerftTask(this, tmp, depth - 2,
+						 rootNodes.last()));
+		}
+		board->undoMove();
+	}
+	pool.waitForDone();
+
+	quint64 total = 0;
+	for (int i = 0; i < rootNodes.size(); i++)
+	{
+		quint64 nodes = rootNodes.at(i)->load();
+		out << moveStrings.at(i) << ": " << nodes << endl;
+		total += nodes;
+		delete rootNodes.at(i);
+	}
+	delete board;
+
+	qint64 elapsed = qMax(timer.elapsed(), qint64(1));
+	out << endl
+	    << "Moves: " << rootMoves.size() << endl
+	    << "Nodes: " << total << endl
+	    << "Time: " << elapsed << " ms" << endl
+	    << "NPS: " << total * 1000 / elapsed << endl;
+
+	return total;
+}
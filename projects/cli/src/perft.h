@@ -0,0 +1,70 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+class QTextStream;
+namespace Chess { class Board; }
+
+/*!
+ * \brief Multithreaded perft with a shared transposition table
+ *
+ * Perft counts the leaf nodes of the legal move tree of a position.
+ * The subtrees after the first two plies are searched in parallel
+ * by a thread pool, and the node counts of the positions are stored
+ * in a transposition table indexed by Board::key().
+ */
+class Perft
+{
+	public:
+		/*!
+		 * Creates a new Perft object for the position of \a board.
+		 * The transposition table has 2^\a hashBits entries.
+		 */
+		Perft(const Chess::Board* board, int hashBits = 21);
+		/*! Destroys the Perft object. */
+		~Perft();
+
+		/*!
+		 * Runs perft to \a depth plies and writes the node count
+		 * of each root move to \a out. Returns the total node count.
+		 */
+		quint64 divide(int depth, QTextStream& out);
+		/*! Returns the node count of \a board to \a depth plies. */
+		quint64 perft(Chess::Board* board, int depth);
+
+	private:
+		struct HashEntry
+		{
+			std::atomic<quint64> check;
+			std::atomic<quint64> data;
+		};
+
+		bool probe(quint64 key, int depth, quint64* nodes) const;
+		void store(quint64 key, int depth, quint64 nodes);
+
+		const Chess::Board* m_board;
+		quint64 m_hashMask;
+		std::unique_ptr<HashEntry[]> m_hash;
+};
+
+#endif // PERFT_H
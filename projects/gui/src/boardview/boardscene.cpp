@@ -603,7 +603,8 @@ void BoardScene::updateMoves()
 	if (!m_board->result().isNone())
 		return;
 
-	const auto moves = m_board->legalMoves();
+	Chess::MoveList moves;
+	m_board->legalMoves(moves);
 	for (const auto& move : moves)
 	{
 		Chess::GenericMove gmove(m_board->genericMove(move));
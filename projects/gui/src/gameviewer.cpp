@@ -187,8 +187,8 @@ void GameViewer::setGame(const PgnGame* pgn)
 	m_moveIndex = 0;
 
 	m_moves.clear();
-	for (const PgnGame::MoveData& md : pgn->moves())
-		m_moves.append(md.move);
+	for (int i = 0; i < pgn->moves().size(); i++)
+		m_moves.append(pgn->genericMove(i));
 
 	m_viewFirstMoveBtn->setEnabled(false);
 	m_viewPreviousMoveBtn->setEnabled(false);
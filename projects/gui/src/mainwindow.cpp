@@ -950,9 +950,11 @@ void MainWindow::editMoveComment(int ply, const QString& comment)
 		PgnGame::MoveData md(pgn->moves().at(ply));
 		md.comment = text;
 		pgn->setMove(ply, md);
+		const Chess::GenericMove move(pgn->genericMove(ply));
+		const QString moveString(pgn->moveStrings().value(ply));
 		unlockCurrentGame();
 
-		m_moveList->setMove(ply, md.move, md.moveString, text);
+		m_moveList->setMove(ply, move, moveString, text);
 	}
 }
 
@@ -123,9 +123,12 @@ void MoveList::setGame(ChessGame* game, PgnGame* pgn)
 
 	m_startingSide = pgn->startingSide();
 	m_moveCount = 0;
+	const QStringList moveStrings(pgn->moveStrings());
 	for (const PgnGame::MoveData& md : pgn->moves())
 	{
-		insertMove(m_moveCount++, md.moveString, md.comment, cursor);
+		insertMove(m_moveCount, moveStrings.value(m_moveCount),
+			   md.comment, cursor);
+		m_moveCount++;
 	}
 	cursor.endEditBlock();
 
@@ -77,9 +77,11 @@ static struct TBEntry_pawn TB_pawn[TBMAX_PAWN];
 
 static struct TBHashEntry TB_hash[1 << TBHASHBITS][HSHMAX];
 
-#define DTZ_ENTRIES 64
-
-static struct DTZTableEntry DTZ_table[DTZ_ENTRIES];
+// DTZ tables are loaded on first use and kept until the next tb_init(),
+// one slot per WDL entry, so that probes never mutate shared state
+// once a table is ready.
+static struct DTZEntry_piece DTZ_piece[TBMAX_PIECE];
+static struct DTZEntry_pawn DTZ_pawn[TBMAX_PAWN];
 
 static void init_indices(void);
 static uint64_t calc_key_from_pcs(int *pcs, int mirror);
@@ -351,9 +353,12 @@ void init_tablebases(const char *path)
       entry = (struct TBEntry *)&TB_pawn[i];
       free_wdl_entry(entry);
     }
-    for (i = 0; i < DTZ_ENTRIES; i++)
-      if (DTZ_table[i].entry)
-	free_dtz_entry(DTZ_table[i].entry);
+    for (i = 0; i < TBnum_piece; i++)
+      if (DTZ_piece[i].ready == 1)
+	free_dtz_entry((struct TBEntry *)&DTZ_piece[i]);
+    for (i = 0; i < TBnum_pawn; i++)
+      if (DTZ_pawn[i].ready == 1)
+	free_dtz_entry((struct TBEntry *)&DTZ_pawn[i]);
   } else {
     init_indices();
     initialized = 1;
@@ -391,8 +396,10 @@ void init_tablebases(const char *path)
       TB_hash[i][j].ptr = NULL;
     }
 
-  for (i = 0; i < DTZ_ENTRIES; i++)
-    DTZ_table[i].entry = NULL;
+  for (i = 0; i < TBMAX_PIECE; i++)
+    DTZ_piece[i].ready = 0;
+  for (i = 0; i < TBMAX_PAWN; i++)
+    DTZ_pawn[i].ready = 0;
 
   for (i = 1; i < 6; i++) {
     snprintf(str, 16, "K%cvK", pchr[i]);
@@ -1633,27 +1640,17 @@ static ubyte decompress_pairs(struct PairsData *d, uint64 idx)
   return *(sympat + 3 * sym);
 }
 
-void load_dtz_table(char *str, uint64 key1, uint64 key2)
+static struct TBEntry *dtz_entry(struct TBEntry *ptr)
 {
-  int i;
-  struct TBEntry *ptr, *ptr3;
-  struct TBHashEntry *ptr2;
-
-  DTZ_table[0].key1 = key1;
-  DTZ_table[0].key2 = key2;
-  DTZ_table[0].entry = NULL;
-
-  // find corresponding WDL entry
-  ptr2 = TB_hash[key1 >> (64 - TBHASHBITS)];
-  for (i = 0; i < HSHMAX; i++)
-    if (ptr2[i].key == key1) break;
-  if (i == HSHMAX) return;
-  ptr = ptr2[i].ptr;
-
-  ptr3 = (struct TBEntry *)malloc(ptr->has_pawns
-				? sizeof(struct DTZEntry_pawn)
-				: sizeof(struct DTZEntry_piece));
+  if (!ptr->has_pawns)
+    return (struct TBEntry *)&DTZ_piece[(struct TBEntry_piece *)ptr - TB_piece];
+  return (struct TBEntry *)&DTZ_pawn[(struct TBEntry_pawn *)ptr - TB_pawn];
+}
 
+// Fill the DTZ entry 'ptr3' for the WDL entry 'ptr'. Must be called with
+// TB_MUTEX held. Returns 0 if the table is missing or corrupted.
+static int load_dtz_table(struct TBEntry *ptr, struct TBEntry *ptr3, char *str)
+{
   ptr3->data = map_file(str, DTZSUFFIX, &ptr3->mapping);
   ptr3->key = ptr->key;
   ptr3->num = ptr->num;
@@ -1667,10 +1664,12 @@ void load_dtz_table(char *str, uint64 key1, uint64 key2)
     struct DTZEntry_piece *entry = (struct DTZEntry_piece *)ptr3;
     entry->enc_type = ((struct TBEntry_piece *)ptr)->enc_type;
   }
-  if (!init_table_dtz(ptr3))
-    free(ptr3);
-  else
-    DTZ_table[0].entry = ptr3;
+  if (!init_table_dtz(ptr3)) {
+    unmap_file(ptr3->data, ptr3->mapping);
+    ptr3->data = NULL;
+    return 0;
+  }
+  return 1;
 }
 
 static void free_wdl_entry(struct TBEntry *entry)
@@ -1704,7 +1703,6 @@ static void free_dtz_entry(struct TBEntry *entry)
     for (f = 0; f < 4; f++)
       free(ptr->file[f].precomp);
   }
-  free(entry);
 }
 
 static int wdl_to_map[5] = { 1, 3, 0, 2, 0 };
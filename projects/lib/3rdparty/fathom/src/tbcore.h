@@ -17,6 +17,10 @@
 #define FD_ERR INVALID_HANDLE_VALUE
 #endif
 
+#if !defined(TB_NO_THREADS) && !defined(TB_HAVE_THREADS)
+#define TB_HAVE_THREADS
+#endif
+
 #ifdef TB_HAVE_THREADS
 #ifndef _WIN32
 #define LOCK_T pthread_mutex_t
@@ -36,6 +40,28 @@
 #define UNLOCK(x)       /* NOP */
 #endif
 
+/* Table ready flags and hash keys are read without TB_MUTEX.  A table
+   is published by storing its ready flag with release semantics after
+   it has been set up, and probers read the flag with acquire semantics
+   before touching the table. */
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define READY_LOAD(x) ((ubyte)_InterlockedOr8((volatile char *)&(x), 0))
+#define READY_STORE(x, v) _InterlockedExchange8((volatile char *)&(x), (char)(v))
+#ifdef _WIN64
+#define KEY_LOAD(x) (*(volatile uint64 *)&(x))
+#else
+#define KEY_LOAD(x) \
+  ((uint64)_InterlockedCompareExchange64((volatile __int64 *)&(x), 0, 0))
+#endif
+#define KEY_STORE(x, v) _InterlockedExchange64((volatile __int64 *)&(x), (__int64)(v))
+#else
+#define READY_LOAD(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define READY_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#define KEY_LOAD(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define KEY_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+#endif
+
 #define WDLSUFFIX ".rtbw"
 #define DTZSUFFIX ".rtbz"
 #define WDLDIR "RTBWDIR"
@@ -163,11 +189,5 @@ struct TBHashEntry {
   struct TBEntry *ptr;
 };
 
-struct DTZTableEntry {
-  uint64 key1;
-  uint64 key2;
-  struct TBEntry *entry;
-};
-
 #endif
 
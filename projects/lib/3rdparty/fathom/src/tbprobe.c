@@ -693,7 +693,7 @@ static int probe_wdl_table(const struct pos *pos, int *success)
     ptr2 = TB_hash[key >> (64 - TBHASHBITS)];
     for (i = 0; i < HSHMAX; i++)
     {
-        if (ptr2[i].key == key)
+        if (KEY_LOAD(ptr2[i].key) == key)
             break;
     }
     if (i == HSHMAX)
@@ -703,7 +703,7 @@ static int probe_wdl_table(const struct pos *pos, int *success)
     }
 
     ptr = ptr2[i].ptr;
-    if (!ptr->ready)
+    if (!READY_LOAD(ptr->ready))
     {
         LOCK(TB_MUTEX);
         if (!ptr->ready)
@@ -712,18 +712,12 @@ static int probe_wdl_table(const struct pos *pos, int *success)
             prt_str(pos, str, ptr->key != key);
             if (!init_table_wdl(ptr, str))
             {
-                ptr2[i].key = 0ULL;
+                KEY_STORE(ptr2[i].key, 0ULL);
                 *success = 0;
                 UNLOCK(TB_MUTEX);
                 return 0;
             }
-            // Memory barrier to ensure ptr->ready = 1 is not reordered.
-#ifdef __GNUC__
-            __asm__ __volatile__ ("" ::: "memory");
-#elif defined(_MSC_VER)
-            MemoryBarrier();
-#endif
-            ptr->ready = 1;
+            READY_STORE(ptr->ready, 1);
         }
         UNLOCK(TB_MUTEX);
     }
@@ -808,49 +802,34 @@ static int probe_dtz_table(const struct pos *pos, int wdl, int *success)
     // Obtain the position's material signature key.
     uint64_t key = calc_key(pos, false);
 
-    if (DTZ_table[0].key1 != key && DTZ_table[0].key2 != key)
+    struct TBHashEntry *ptr2 = TB_hash[key >> (64 - TBHASHBITS)];
+    for (i = 0; i < HSHMAX; i++)
     {
-        for (i = 1; i < DTZ_ENTRIES; i++)
-        {
-            if (DTZ_table[i].key1 == key)
-                break;
-        }
-        if (i < DTZ_ENTRIES)
-        {
-            struct DTZTableEntry table_entry = DTZ_table[i];
-            for (; i > 0; i--)
-                DTZ_table[i] = DTZ_table[i - 1];
-            DTZ_table[0] = table_entry;
-        }
-        else
+        if (KEY_LOAD(ptr2[i].key) == key)
+            break;
+    }
+    if (i == HSHMAX)
+    {
+        *success = 0;
+        return 0;
+    }
+
+    // DTZ entries are never evicted, so only the first probe of each
+    // table needs the lock.  A ready value of 2 marks a missing table.
+    ptr = dtz_entry(ptr2[i].ptr);
+    if (!READY_LOAD(ptr->ready))
+    {
+        LOCK(TB_MUTEX);
+        if (!ptr->ready)
         {
-            struct TBHashEntry *ptr2 = TB_hash[key >> (64 - TBHASHBITS)];
-            for (i = 0; i < HSHMAX; i++)
-            {
-                if (ptr2[i].key == key)
-                    break;
-            }
-            if (i == HSHMAX)
-            {
-                *success = 0;
-                return 0;
-            }
-            ptr = ptr2[i].ptr;
             char str[16];
-            int mirror = (ptr->key != key);
-            prt_str(pos, str, mirror);
-            if (DTZ_table[DTZ_ENTRIES - 1].entry)
-                free_dtz_entry(DTZ_table[DTZ_ENTRIES-1].entry);
-            for (i = DTZ_ENTRIES - 1; i > 0; i--)
-                DTZ_table[i] = DTZ_table[i - 1];
-            uint64_t key1 = calc_key(pos, mirror);
-            uint64_t key2 = calc_key(pos, !mirror);
-            load_dtz_table(str, key1, key2);
+            prt_str(pos, str, ptr2[i].ptr->key != key);
+            int loaded = load_dtz_table(ptr2[i].ptr, ptr, str);
+            READY_STORE(ptr->ready, loaded ? 1 : 2);
         }
+        UNLOCK(TB_MUTEX);
     }
-
-    ptr = DTZ_table[0].entry;
-    if (!ptr)
+    if (READY_LOAD(ptr->ready) != 1)
     {
         *success = 0;
         return 0;
@@ -0,0 +1,260 @@
+/*
+ * A benchmark for the board layer.
+ *
+ * Every variant in BoardFactory::variants() is benchmarked in a small
+ * corpus of positions: the starting position and the positions after
+ * a fixed sequence of moves. The results are written to standard
+ * output as CSV with the following columns:
+ *
+ *   variant,position,operation,iterations,ops_per_sec,allocs_per_op
+ *
+ * With glibc every call to malloc(), calloc() and realloc() is counted
+ * as an allocation. Elsewhere allocs_per_op is -1.
+ *
+ * Usage: boardbench [variant...]
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <atomic>
+#include <cstdlib>
+#include <board/board.h>
+#include <board/boardfactory.h>
+#include <mersenne.h>
+
+#ifdef __GLIBC__
+#define BOARDBENCH_COUNT_ALLOCS
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+static std::atomic<quint64> s_allocCount(0);
+
+extern "C" void* malloc(size_t size)
+{
+	s_allocCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+	s_allocCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+	s_allocCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_realloc(ptr, size);
+}
+#endif
+
+namespace {
+
+// Minimum time spent in each benchmark
+const qint64 s_minTime = 200;
+// Number of plies of the fixed move sequences
+const int s_corpusPlies[] = { 0, 8, 24 };
+// Depth of the perft benchmark
+const int s_perftDepth = 3;
+
+quint64 allocCount()
+{
+#ifdef BOARDBENCH_COUNT_ALLOCS
+	return s_allocCount.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+quint64 perft(Chess::Board* board, int depth)
+{
+	Chess::MoveList moves;
+	board->legalMoves(moves);
+	if (depth <= 1)
+		return moves.size();
+
+	quint64 nodes = 0;
+	for (const Chess::Move& move : moves)
+	{
+		board->makeMove(move);
+		nodes += perft(board, depth - 1);
+		board->undoMove();
+	}
+
+	return nodes;
+}
+
+/*
+ * Plays \a plies moves from the starting position. The n-th move is
+ * chosen from the legal moves by a formula, so the sequence is the
+ * same in every run. Returns the FEN string of the final position.
+ */
+QString corpusPosition(Chess::Board* board, int plies)
+{
+	board->reset();
+	for (int i = 0; i < plies; i++)
+	{
+		if (!board->result().isNone())
+			break;
+
+		Chess::MoveList moves;
+		board->legalMoves(moves);
+		board->makeMove(moves[(i * 7 + 3) % moves.size()]);
+	}
+
+	return board->fenString();
+}
+
+class Benchmark
+{
+	public:
+		Benchmark(QTextStream& out,
+			  const QString& variant,
+			  int position)
+			: m_out(out),
+			  m_variant(variant),
+			  m_position(position)
+		{
+		}
+
+		/*
+		 * Runs \a op until at least s_minTime milliseconds have
+		 * passed. Each call of \a op performs \a opCount operations.
+		 */
+		template<typename Op>
+		void run(const QString& name, int opCount, Op op)
+		{
+			if (opCount <= 0)
+				return;
+
+			// Warm up
+			op();
+
+			QElapsedTimer timer;
+			quint64 iterations = 0;
+			quint64 allocs = allocCount();
+			timer.start();
+
+			do
+			{
+				op();
+				iterations++;
+			}
+			while (timer.elapsed() < s_minTime);
+
+			qint64 nsecs = timer.nsecsElapsed();
+			allocs = allocCount() - allocs;
+
+			double ops = double(iterations) * opCount;
+			double opsPerSec = ops * 1e9 / nsecs;
+#ifdef BOARDBENCH_COUNT_ALLOCS
+			double allocsPerOp = double(allocs) / ops;
+#else
+			double allocsPerOp = -1.0;
+#endif
+
+			m_out << m_variant << ',' << m_position << ','
+			      << name << ',' << quint64(ops) << ','
+			      << QString::number(opsPerSec, 'f', 0) << ','
+			      << QString::number(allocsPerOp, 'f', 3) << '\n';
+			m_out.flush();
+		}
+
+	private:
+		QTextStream& m_out;
+		QString m_variant;
+		int m_position;
+};
+
+void benchmarkVariant(QTextStream& out, const QString& variant)
+{
+	Chess::Board* board = Chess::BoardFactory::create(variant);
+	Q_ASSERT(board != nullptr);
+
+	// Random variants get the same starting position in every run
+	Mersenne::initialize(1);
+
+	for (const int plies : s_corpusPlies)
+	{
+		const QString fen = corpusPosition(board, plies);
+		if (!board->setFenString(fen))
+		{
+			qWarning("Invalid corpus position for %s: %s",
+				 qUtf8Printable(variant),
+				 qUtf8Printable(fen));
+			continue;
+		}
+
+		Chess::MoveList moves;
+		board->legalMoves(moves);
+		QStringList sanMoves;
+		for (const Chess::Move& move : moves)
+			sanMoves << board->moveString(move, Chess::Board::StandardAlgebraic);
+
+		Benchmark bench(out, variant, plies);
+
+		bench.run("perft", 1, [&]()
+		{
+			perft(board, s_perftDepth);
+		});
+		bench.run("legalMoves", 1, [&]()
+		{
+			Chess::MoveList tmp;
+			board->legalMoves(tmp);
+		});
+		bench.run("result", 1, [&]()
+		{
+			board->result();
+		});
+		bench.run("sanMoveString", moves.size(), [&]()
+		{
+			for (const Chess::Move& move : moves)
+				board->moveString(move, Chess::Board::StandardAlgebraic);
+		});
+		bench.run("moveFromSanString", sanMoves.size(), [&]()
+		{
+			for (const QString& str : sanMoves)
+				board->moveFromString(str);
+		});
+		bench.run("fenString", 1, [&]()
+		{
+			board->fenString();
+		});
+		bench.run("setFenString", 1, [&]()
+		{
+			board->setFenString(fen);
+		});
+	}
+
+	delete board;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	QStringList variants = app.arguments().mid(1);
+	if (variants.isEmpty())
+		variants = Chess::BoardFactory::variants();
+
+	QTextStream out(stdout);
+	out << "variant,position,operation,iterations,ops_per_sec,allocs_per_op\n";
+
+	for (const QString& variant : variants)
+	{
+		if (!Chess::BoardFactory::variants().contains(variant))
+		{
+			qWarning("Unknown variant: %s", qUtf8Printable(variant));
+			return 1;
+		}
+		benchmarkVariant(out, variant);
+	}
+
+	return 0;
+}
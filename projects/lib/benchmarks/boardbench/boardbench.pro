@@ -0,0 +1,6 @@
+include(../benchmarks.pri)
+include(../../libexport.pri)
+
+QT = core
+TARGET = boardbench
+SOURCES += boardbench.cpp
@@ -0,0 +1,156 @@
+#include <QtTest/QtTest>
+#include <uciengine.h>
+#include <enginetoken.h>
+
+namespace {
+
+/*
+ * Engine output in Stockfish's format for a search of the starting
+ * position to depth 22: an info string, one info line per iteration,
+ * currmove updates from depth 10 and a fail-high line at depth 18.
+ */
+const char s_stockfishOutput[] =
+	"info string NNUE evaluation using nn-ad9b42354671.nnue enabled\n"
+	"info depth 1 seldepth 2 multipv 1 score cp 18 nodes 76 nps 76000 hashfull 0 tbhits 0 time 1 pv e2e4\n"
+	"info depth 2 seldepth 3 multipv 1 score cp 46 nodes 220 nps 220000 hashfull 0 tbhits 0 time 1 pv e2e4 e7e5\n"
+	"info depth 3 seldepth 5 multipv 1 score cp 39 nodes 494 nps 494000 hashfull 0 tbhits 0 time 1 pv e2e4 e7e5 g1f3\n"
+	"info depth 4 seldepth 8 multipv 1 score cp 35 nodes 1015 nps 1015000 hashfull 0 tbhits 0 time 1 pv e2e4 e7e5 g1f3 b8c6\n"
+	"info depth 5 seldepth 7 multipv 1 score cp 28 nodes 2005 nps 2005000 hashfull 0 tbhits 0 time 1 pv e2e4 e7e5 g1f3 b8c6 f1b5\n"
+	"info depth 6 seldepth 9 multipv 1 score cp 31 nodes 3886 nps 1295333 hashfull 0 tbhits 0 time 3 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6\n"
+	"info depth 7 seldepth 12 multipv 1 score cp 27 nodes 7461 nps 1243500 hashfull 0 tbhits 0 time 6 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1\n"
+	"info depth 8 seldepth 12 multipv 1 score cp 30 nodes 14254 nps 1187833 hashfull 0 tbhits 0 time 12 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4\n"
+	"info depth 9 seldepth 14 multipv 1 score cp 33 nodes 27161 nps 1131708 hashfull 0 tbhits 0 time 24 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1\n"
+	"info depth 10 currmove e2e4 currmovenumber 1\n"
+	"info depth 10 currmove d2d4 currmovenumber 2\n"
+	"info depth 10 currmove g1f3 currmovenumber 3\n"
+	"info depth 10 currmove c2c4 currmovenumber 4\n"
+	"info depth 10 seldepth 17 multipv 1 score cp 29 nodes 51685 nps 1123586 hashfull 0 tbhits 0 time 46 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6\n"
+	"info depth 11 currmove e2e4 currmovenumber 1\n"
+	"info depth 11 currmove d2d4 currmovenumber 2\n"
+	"info depth 11 currmove g1f3 currmovenumber 3\n"
+	"info depth 11 currmove c2c4 currmovenumber 4\n"
+	"info depth 11 seldepth 16 multipv 1 score cp 35 nodes 98281 nps 1104280 hashfull 1 tbhits 0 time 89 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5\n"
+	"info depth 12 currmove e2e4 currmovenumber 1\n"
+	"info depth 12 currmove d2d4 currmovenumber 2\n"
+	"info depth 12 currmove g1f3 currmovenumber 3\n"
+	"info depth 12 currmove c2c4 currmovenumber 4\n"
+	"info depth 12 seldepth 20 multipv 1 score cp 31 nodes 186813 nps 1105402 hashfull 3 tbhits 0 time 169 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7\n"
+	"info depth 13 currmove e2e4 currmovenumber 1\n"
+	"info depth 13 currmove d2d4 currmovenumber 2\n"
+	"info depth 13 currmove g1f3 currmovenumber 3\n"
+	"info depth 13 currmove c2c4 currmovenumber 4\n"
+	"info depth 13 seldepth 19 multipv 1 score cp 34 nodes 355024 nps 1102559 hashfull 5 tbhits 0 time 322 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1\n"
+	"info depth 14 currmove e2e4 currmovenumber 1\n"
+	"info depth 14 currmove d2d4 currmovenumber 2\n"
+	"info depth 14 currmove g1f3 currmovenumber 3\n"
+	"info depth 14 currmove c2c4 currmovenumber 4\n"
+	"info depth 14 seldepth 21 multipv 1 score cp 30 nodes 674626 nps 1100531 hashfull 11 tbhits 0 time 613 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5\n"
+	"info depth 15 currmove e2e4 currmovenumber 1\n"
+	"info depth 15 currmove d2d4 currmovenumber 2\n"
+	"info depth 15 currmove g1f3 currmovenumber 3\n"
+	"info depth 15 currmove c2c4 currmovenumber 4\n"
+	"info depth 15 seldepth 22 multipv 1 score cp 28 nodes 1281871 nps 1100318 hashfull 21 tbhits 0 time 1165 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5\n"
+	"info depth 16 currmove e2e4 currmovenumber 1\n"
+	"info depth 16 currmove d2d4 currmovenumber 2\n"
+	"info depth 16 currmove g1f3 currmovenumber 3\n"
+	"info depth 16 currmove c2c4 currmovenumber 4\n"
+	"info depth 16 seldepth 25 multipv 1 score cp 32 nodes 2435636 nps 1100106 hashfull 40 tbhits 0 time 2214 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8\n"
+	"info depth 17 currmove e2e4 currmovenumber 1\n"
+	"info depth 17 currmove d2d4 currmovenumber 2\n"
+	"info depth 17 currmove g1f3 currmovenumber 3\n"
+	"info depth 17 currmove c2c4 currmovenumber 4\n"
+	"info depth 17 seldepth 26 multipv 1 score cp 33 nodes 4627790 nps 1100021 hashfull 77 tbhits 0 time 4207 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4\n"
+	"info depth 18 currmove e2e4 currmovenumber 1\n"
+	"info depth 18 currmove d2d4 currmovenumber 2\n"
+	"info depth 18 currmove g1f3 currmovenumber 3\n"
+	"info depth 18 currmove c2c4 currmovenumber 4\n"
+	"info depth 18 seldepth 27 multipv 1 score cp 31 nodes 8792884 nps 1100073 hashfull 146 tbhits 0 time 7993 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4 e7f6\n"
+	"info depth 18 seldepth 27 multipv 1 score cp 45 lowerbound nodes 8794084 nps 1100073 hashfull 146 tbhits 0 time 7994 pv e2e4\n"
+	"info depth 19 currmove e2e4 currmovenumber 1\n"
+	"info depth 19 currmove d2d4 currmovenumber 2\n"
+	"info depth 19 currmove g1f3 currmovenumber 3\n"
+	"info depth 19 currmove c2c4 currmovenumber 4\n"
+	"info depth 19 seldepth 28 multipv 1 score cp 29 nodes 16706562 nps 1100056 hashfull 278 tbhits 0 time 15187 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4 e7f6 e5e1\n"
+	"info depth 20 currmove e2e4 currmovenumber 1\n"
+	"info depth 20 currmove d2d4 currmovenumber 2\n"
+	"info depth 20 currmove g1f3 currmovenumber 3\n"
+	"info depth 20 currmove c2c4 currmovenumber 4\n"
+	"info depth 20 seldepth 30 multipv 1 score cp 34 nodes 31742551 nps 1100032 hashfull 529 tbhits 0 time 28856 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4 e7f6 e5e1 f8e8\n"
+	"info depth 21 currmove e2e4 currmovenumber 1\n"
+	"info depth 21 currmove d2d4 currmovenumber 2\n"
+	"info depth 21 currmove g1f3 currmovenumber 3\n"
+	"info depth 21 currmove c2c4 currmovenumber 4\n"
+	"info depth 21 seldepth 33 multipv 1 score cp 30 nodes 60310930 nps 1100002 hashfull 999 tbhits 0 time 54828 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4 e7f6 e5e1 f8e8 c2c3\n"
+	"info depth 22 currmove e2e4 currmovenumber 1\n"
+	"info depth 22 currmove d2d4 currmovenumber 2\n"
+	"info depth 22 currmove g1f3 currmovenumber 3\n"
+	"info depth 22 currmove c2c4 currmovenumber 4\n"
+	"info depth 22 seldepth 34 multipv 1 score cp 32 nodes 114590851 nps 1100005 hashfull 999 tbhits 0 time 104173 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4 e7f6 e5e1 f8e8 c2c3 e8e1\n";
+
+// Exposes the engine's line parser
+class UciParser : public UciEngine
+{
+	public:
+		using UciEngine::parseLine;
+};
+
+QList<QByteArray> outputLines()
+{
+	QList<QByteArray> lines = QByteArray(s_stockfishOutput).split('\n');
+	lines.removeAll(QByteArray());
+	return lines;
+}
+
+} // anonymous namespace
+
+class tst_EngineOutput: public QObject
+{
+	Q_OBJECT
+
+	private slots:
+		void tokenizer();
+		void uciParser();
+};
+
+void tst_EngineOutput::tokenizer()
+{
+	const auto lines = outputLines();
+	quint64 nodes = 0;
+
+	QBENCHMARK
+	{
+		for (const QByteArray& line : lines)
+		{
+			EngineToken token(EngineToken::first(line.constData(),
+							     line.size()));
+			while (!(token = token.next()).isNull())
+			{
+				if (token == "nodes")
+					nodes = (token = token.next()).toULongLong();
+			}
+		}
+	}
+	QCOMPARE(nodes, Q_UINT64_C(114590851));
+}
+
+void tst_EngineOutput::uciParser()
+{
+	const auto lines = outputLines();
+	UciParser engine;
+
+	QBENCHMARK
+	{
+		for (const QByteArray& line : lines)
+			engine.parseLine(line.constData(), line.size());
+	}
+
+	const MoveEvaluation& eval = engine.evaluation();
+	QCOMPARE(eval.depth(), 22);
+	QCOMPARE(eval.selectiveDepth(), 34);
+	QCOMPARE(eval.score(), 32);
+	QCOMPARE(eval.nodeCount(), Q_UINT64_C(114590851));
+	QVERIFY(eval.pv().startsWith("e2e4 e7e5 g1f3 b8c6 f1b5"));
+}
+
+QTEST_MAIN(tst_EngineOutput)
+#include "tst_engineoutput.moc"
@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+include(../../libexport.pri)
+
+TARGET = tst_enginespawn
+SOURCES += tst_enginespawn.cpp
@@ -0,0 +1,96 @@
+#include <QtTest/QtTest>
+#include <QProcess>
+#include <engineprocess.h>
+
+namespace {
+
+/*
+ * Starts a process that exits immediately and waits for it to
+ * finish, which is the cost of restarting an engine for each game.
+ */
+template<typename Process>
+void spawnAndExit()
+{
+	QBENCHMARK
+	{
+		Process process;
+		process.start("true");
+		QVERIFY(process.waitForStarted());
+		QVERIFY(process.waitForFinished());
+	}
+}
+
+/*
+ * Starts a process that echoes its input, sends it a line, waits for
+ * the line to come back and closes the process.
+ */
+template<typename Process>
+void spawnAndRoundTrip()
+{
+	QBENCHMARK
+	{
+		Process process;
+		process.start("cat");
+		QVERIFY(process.waitForStarted());
+		process.write("isready\n");
+
+		QEventLoop loop;
+		QTimer timeout;
+		timeout.setSingleShot(true);
+		QObject::connect(&process, SIGNAL(readyRead()),
+				 &loop, SLOT(quit()));
+		QObject::connect(&timeout, SIGNAL(timeout()),
+				 &loop, SLOT(quit()));
+		timeout.start(5000);
+		while (!process.canReadLine() && timeout.isActive())
+			loop.exec();
+
+		QCOMPARE(process.readLine(), QByteArray("isready\n"));
+		process.close();
+	}
+}
+
+} // anonymous namespace
+
+class tst_EngineSpawn: public QObject
+{
+	Q_OBJECT
+
+	private slots:
+		void init();
+
+		void engineProcess();
+		void qProcess();
+		void engineProcessRoundTrip();
+		void qProcessRoundTrip();
+};
+
+void tst_EngineSpawn::init()
+{
+#ifdef Q_OS_WIN32
+	QSKIP("The benchmark programs are not available on Windows");
+#endif
+}
+
+void tst_EngineSpawn::engineProcess()
+{
+	spawnAndExit<EngineProcess>();
+}
+
+void tst_EngineSpawn::qProcess()
+{
+	spawnAndExit<QProcess>();
+}
+
+void tst_EngineSpawn::engineProcessRoundTrip()
+{
+	spawnAndRoundTrip<EngineProcess>();
+}
+
+void tst_EngineSpawn::qProcessRoundTrip()
+{
+	spawnAndRoundTrip<QProcess>();
+}
+
+QTEST_MAIN(tst_EngineSpawn)
+#include "tst_enginespawn.moc"
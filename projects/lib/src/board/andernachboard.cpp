@@ -34,6 +34,11 @@ QString AndernachBoard::variant() const
 	return "andernach";
 }
 
+bool AndernachBoard::hasStandardMoveNotation() const
+{
+	return false;
+}
+
 Move AndernachBoard::moveFromSanString(const QString& str)
 {
 	// import: ignore redundant move information in brackets: Nxd5(=bN)
@@ -94,6 +99,11 @@ bool AndernachBoard::switchesSides(const Move& move) const
 	&&     pieceAt(move.sourceSquare()).type() != King;
 }
 
+bool AndernachBoard::hasStandardLegality() const
+{
+	return false;
+}
+
 
 
 AntiAndernachBoard::AntiAndernachBoard()
@@ -57,7 +57,7 @@ bool AntiBoard::kingsCountAssertion( int whiteKings,
 
 void AntiBoard::addPromotions(int sourceSquare,
 				int targetSquare,
-				QVarLengthArray<Move>& moves) const
+				MoveList& moves) const
 {
 	StandardBoard::addPromotions(sourceSquare, targetSquare, moves);
 	moves.append(Move(sourceSquare, targetSquare, King));
@@ -75,6 +75,11 @@ bool AntiBoard::inCheck(Side, int) const
 	return false;
 }
 
+bool AntiBoard::hasStandardLegality() const
+{
+	return false;
+}
+
 bool AntiBoard::vIsLegalMove(const Move& move)
 {
 	if (!StandardBoard::vIsLegalMove(move))
@@ -88,7 +93,7 @@ bool AntiBoard::vIsLegalMove(const Move& move)
 	{
 		m_testKey = key();
 		m_canCapture = false;
-		QVarLengthArray<Move> moves;
+		MoveList moves;
 		generateMoves(moves);
 
 		// search for any legal capture move
@@ -67,10 +67,11 @@ class LIB_EXPORT AntiBoard : public StandardBoard
 						 int blackKings) const;
 		virtual bool vSetFenString(const QStringList& fen);
 		virtual bool inCheck(Side side, int square = 0) const;
+		virtual bool hasStandardLegality() const;
 		virtual bool vIsLegalMove(const Move& move);
 		virtual void addPromotions(int sourceSquare,
 					   int targetSquare,
-					   QVarLengthArray<Move>& moves) const;
+					   MoveList& moves) const;
 
 		/*! Rules stalemate outcome. */
 		virtual Result vResultOfStalemate() const;
@@ -49,6 +49,11 @@ bool AtomicBoard::kingCanCapture() const
 	return false;
 }
 
+bool AtomicBoard::useBitboards() const
+{
+	return true;
+}
+
 void AtomicBoard::vInitialize()
 {
 	int arwidth = width() + 2;
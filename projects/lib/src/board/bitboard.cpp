@@ -0,0 +1,294 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bitboard.h"
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using Chess::Bitboard;
+
+struct Magic
+{
+	Bitboard mask;
+	Bitboard magic;
+	Bitboard* attacks;
+	int shift;
+
+	int index(Bitboard occupied) const
+	{
+	#ifdef __BMI2__
+		return int(_pext_u64(occupied, mask));
+	#else
+		return int(((occupied & mask) * magic) >> shift);
+	#endif
+	}
+};
+
+Bitboard s_knightAttacks[64];
+Bitboard s_kingAttacks[64];
+Bitboard s_pawnAttacks[2][64];
+Bitboard s_rookTable[0x19000];
+Bitboard s_bishopTable[0x1480];
+Bitboard s_between[64][64];
+Bitboard s_line[64][64];
+Magic s_rookMagics[64];
+Magic s_bishopMagics[64];
+
+const int s_rookSteps[4][2] = { {-1, 0}, {0, -1}, {0, 1}, {1, 0} };
+const int s_bishopSteps[4][2] = { {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+const int s_knightSteps[8][2] = {
+	{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
+	{1, -2}, {1, 2}, {2, -1}, {2, 1}
+};
+const int s_kingSteps[8][2] = {
+	{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+	{0, 1}, {1, -1}, {1, 0}, {1, 1}
+};
+
+// Row 0 is the 8th rank, row 7 is the 1st rank
+inline bool isOnBoard(int row, int file)
+{
+	return row >= 0 && row < 8 && file >= 0 && file < 8;
+}
+
+inline Bitboard bit(int row, int file)
+{
+	return Bitboard(1) << (row * 8 + file);
+}
+
+Bitboard stepAttacks(int square, const int (*steps)[2], int count)
+{
+	Bitboard attacks = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int row = (square >> 3) + steps[i][0];
+		int file = (square & 7) + steps[i][1];
+		if (isOnBoard(row, file))
+			attacks |= bit(row, file);
+	}
+	return attacks;
+}
+
+Bitboard slidingAttacks(int square, Bitboard occupied, const int (*steps)[2])
+{
+	Bitboard attacks = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		int row = (square >> 3) + steps[i][0];
+		int file = (square & 7) + steps[i][1];
+		while (isOnBoard(row, file))
+		{
+			attacks |= bit(row, file);
+			if (occupied & bit(row, file))
+				break;
+			row += steps[i][0];
+			file += steps[i][1];
+		}
+	}
+	return attacks;
+}
+
+#ifndef __BMI2__
+// Xorshift64* generator with a fixed seed, so that the magic
+// numbers are the same on every run.
+quint64 s_randomState = 0x1d8e4e27c47d124fULL;
+
+quint64 random64()
+{
+	s_randomState ^= s_randomState >> 12;
+	s_randomState ^= s_randomState << 25;
+	s_randomState ^= s_randomState >> 27;
+	return s_randomState * 2685821657736338717ULL;
+}
+#endif
+
+void initMagics(Magic* magics, Bitboard* table, const int (*steps)[2])
+{
+	Bitboard occupancy[4096];
+	Bitboard reference[4096];
+	int epoch[4096] = {};
+	int attempt = 0;
+	int size = 0;
+
+	for (int sq = 0; sq < 64; sq++)
+	{
+		int row = sq >> 3;
+		int file = sq & 7;
+
+		// The edge squares don't affect the attacks, unless the
+		// piece itself is on that edge.
+		Bitboard edges = 0;
+		for (int i = 0; i < 8; i++)
+		{
+			if (row != 0)
+				edges |= bit(0, i);
+			if (row != 7)
+				edges |= bit(7, i);
+			if (file != 0)
+				edges |= bit(i, 0);
+			if (file != 7)
+				edges |= bit(i, 7);
+		}
+
+		Magic& m = magics[sq];
+		m.mask = slidingAttacks(sq, 0, steps) & ~edges;
+		m.shift = 64 - Chess::BitboardAttacks::popCount(m.mask);
+		m.attacks = (sq == 0) ? table : magics[sq - 1].attacks + size;
+
+		// Enumerate all subsets of the mask with the
+		// Carry-Rippler trick.
+		Bitboard b = 0;
+		size = 0;
+		do
+		{
+			occupancy[size] = b;
+			reference[size] = slidingAttacks(sq, b, steps);
+		#ifdef __BMI2__
+			m.attacks[_pext_u64(b, m.mask)] = reference[size];
+		#endif
+			size++;
+			b = (b - m.mask) & m.mask;
+		} while (b != 0);
+
+	#ifndef __BMI2__
+		// Find a magic number that maps every subset of the mask
+		// to an index with the correct attacks.
+		for (int i = 0; i < size; )
+		{
+			do
+				m.magic = random64() & random64() & random64();
+			while (Chess::BitboardAttacks::popCount(
+				(m.magic * m.mask) >> 56) < 6);
+
+			attempt++;
+			for (i = 0; i < size; i++)
+			{
+				int index = m.index(occupancy[i]);
+				if (epoch[index] < attempt)
+				{
+					epoch[index] = attempt;
+					m.attacks[index] = reference[i];
+				}
+				else if (m.attacks[index] != reference[i])
+					break;
+			}
+		}
+	#else
+		Q_UNUSED(occupancy);
+		Q_UNUSED(epoch);
+		Q_UNUSED(attempt);
+	#endif
+	}
+}
+
+bool initTables()
+{
+	for (int sq = 0; sq < 64; sq++)
+	{
+		s_knightAttacks[sq] = stepAttacks(sq, s_knightSteps, 8);
+		s_kingAttacks[sq] = stepAttacks(sq, s_kingSteps, 8);
+
+		// White pawns move towards row 0, black pawns towards row 7
+		const int whiteSteps[2][2] = { {-1, -1}, {-1, 1} };
+		const int blackSteps[2][2] = { {1, -1}, {1, 1} };
+		s_pawnAttacks[Chess::Side::White][sq] = stepAttacks(sq, whiteSteps, 2);
+		s_pawnAttacks[Chess::Side::Black][sq] = stepAttacks(sq, blackSteps, 2);
+	}
+
+	initMagics(s_rookMagics, s_rookTable, s_rookSteps);
+	initMagics(s_bishopMagics, s_bishopTable, s_bishopSteps);
+
+	for (int sq1 = 0; sq1 < 64; sq1++)
+	{
+		const Bitboard bit1 = Bitboard(1) << sq1;
+		const Bitboard rook1 = slidingAttacks(sq1, 0, s_rookSteps);
+		const Bitboard bishop1 = slidingAttacks(sq1, 0, s_bishopSteps);
+
+		for (int sq2 = 0; sq2 < 64; sq2++)
+		{
+			const Bitboard bit2 = Bitboard(1) << sq2;
+			const int (*steps)[2] = nullptr;
+			if (rook1 & bit2)
+				steps = s_rookSteps;
+			else if (bishop1 & bit2)
+				steps = s_bishopSteps;
+			else
+				continue;
+
+			s_between[sq1][sq2] = slidingAttacks(sq1, bit2, steps)
+					    & slidingAttacks(sq2, bit1, steps);
+			s_line[sq1][sq2] = (slidingAttacks(sq1, 0, steps)
+					 &  slidingAttacks(sq2, 0, steps))
+					 | bit1 | bit2;
+		}
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+namespace Chess {
+
+void BitboardAttacks::initialize()
+{
+	static const bool initialized = initTables();
+	Q_UNUSED(initialized);
+}
+
+Bitboard BitboardAttacks::knightAttacks(int square)
+{
+	return s_knightAttacks[square];
+}
+
+Bitboard BitboardAttacks::kingAttacks(int square)
+{
+	return s_kingAttacks[square];
+}
+
+Bitboard BitboardAttacks::pawnAttacks(Side side, int square)
+{
+	Q_ASSERT(!side.isNull());
+	return s_pawnAttacks[side][square];
+}
+
+Bitboard BitboardAttacks::bishopAttacks(int square, Bitboard occupied)
+{
+	const Magic& m = s_bishopMagics[square];
+	return m.attacks[m.index(occupied)];
+}
+
+Bitboard BitboardAttacks::rookAttacks(int square, Bitboard occupied)
+{
+	const Magic& m = s_rookMagics[square];
+	return m.attacks[m.index(occupied)];
+}
+
+Bitboard BitboardAttacks::between(int square1, int square2)
+{
+	return s_between[square1][square2];
+}
+
+Bitboard BitboardAttacks::line(int square1, int square2)
+{
+	return s_line[square1][square2];
+}
+
+} // namespace Chess
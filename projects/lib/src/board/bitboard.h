@@ -0,0 +1,145 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <QtGlobal>
+#include "side.h"
+
+namespace Chess {
+
+/*! A set of squares on an 8x8 board, one bit per square. */
+typedef quint64 Bitboard;
+
+/*!
+ * \brief Attack tables for bitboard move generation on 8x8 boards
+ *
+ * The squares of a bitboard are numbered from 0 (a8) to 63 (h1), ie.
+ * in the same order as the squares of Board's internal square array.
+ * That way iterating over a bitboard from the least significant bit
+ * visits the squares in the same order as the mailbox move generator.
+ *
+ * Sliding piece attacks are looked up from magic bitboard tables, or
+ * with the PEXT instruction if the library is compiled for BMI2.
+ *
+ * \sa Board::hasBitboards()
+ */
+class LIB_EXPORT BitboardAttacks
+{
+	public:
+		/*!
+		 * Initializes the attack tables.
+		 *
+		 * This function is thread-safe, and it's cheap to call it
+		 * again after the first time.
+		 */
+		static void initialize();
+
+		/*! Returns the squares a knight attacks from \a square. */
+		static Bitboard knightAttacks(int square);
+		/*! Returns the squares a king attacks from \a square. */
+		static Bitboard kingAttacks(int square);
+		/*! Returns the squares a pawn of \a side attacks from \a square. */
+		static Bitboard pawnAttacks(Side side, int square);
+		/*!
+		 * Returns the squares a bishop attacks from \a square when
+		 * the occupied squares are \a occupied.
+		 */
+		static Bitboard bishopAttacks(int square, Bitboard occupied);
+		/*!
+		 * Returns the squares a rook attacks from \a square when
+		 * the occupied squares are \a occupied.
+		 */
+		static Bitboard rookAttacks(int square, Bitboard occupied);
+		/*!
+		 * Returns the squares between \a square1 and \a square2,
+		 * not including the squares themselves.
+		 *
+		 * Returns an empty bitboard if the squares aren't on the
+		 * same rank, file or diagonal.
+		 */
+		static Bitboard between(int square1, int square2);
+		/*!
+		 * Returns the whole rank, file or diagonal that goes through
+		 * \a square1 and \a square2.
+		 *
+		 * Returns an empty bitboard if the squares aren't on the
+		 * same rank, file or diagonal.
+		 */
+		static Bitboard line(int square1, int square2);
+
+		/*! Returns a bitboard with only \a square set. */
+		static Bitboard squareBit(int square);
+		/*! Returns the number of squares in \a bb. */
+		static int popCount(Bitboard bb);
+		/*! Removes the lowest square from \a bb and returns it. */
+		static int popLsb(Bitboard& bb);
+
+		/*! Converts an 8x8 Board square index into a bitboard square. */
+		static int fromIndex(int index);
+		/*! Converts a bitboard square into an 8x8 Board square index. */
+		static int toIndex(int square);
+};
+
+
+inline Bitboard BitboardAttacks::squareBit(int square)
+{
+	Q_ASSERT(square >= 0 && square < 64);
+	return Bitboard(1) << square;
+}
+
+inline int BitboardAttacks::popCount(Bitboard bb)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(bb);
+#else
+	int count = 0;
+	for (; bb != 0; bb &= bb - 1)
+		count++;
+	return count;
+#endif
+}
+
+inline int BitboardAttacks::popLsb(Bitboard& bb)
+{
+	Q_ASSERT(bb != 0);
+#if defined(__GNUC__)
+	int square = __builtin_ctzll(bb);
+#else
+	int square = 0;
+	while (!(bb & (Bitboard(1) << square)))
+		square++;
+#endif
+	bb &= bb - 1;
+	return square;
+}
+
+inline int BitboardAttacks::fromIndex(int index)
+{
+	// An 8x8 board array is 10 squares wide with two wall
+	// ranks at the top and one wall file on the left.
+	return (index / 10 - 2) * 8 + index % 10 - 1;
+}
+
+inline int BitboardAttacks::toIndex(int square)
+{
+	return ((square >> 3) + 2) * 10 + 1 + (square & 7);
+}
+
+} // namespace Chess
+#endif // BITBOARD_H
@@ -16,8 +16,10 @@
 */
 
 #include "board.h"
+#include <algorithm>
 #include <QStringList>
 #include "zobrist.h"
+#include "boardgeometry.h"
 
 
 namespace Chess {
@@ -55,12 +57,18 @@ Board::Board(Zobrist* zobrist)
 	: m_initialized(false),
 	  m_width(0),
 	  m_height(0),
+	  m_geometry(AnyGeometry),
 	  m_side(Side::White),
 	  m_startingSide(Side::White),
 	  m_maxPieceSymbolLength(1),
 	  m_key(0),
 	  m_zobrist(zobrist),
-	  m_sharedZobrist(zobrist)
+	  m_sharedZobrist(zobrist),
+	  m_legalMoveKey(0),
+	  m_legalMovePly(-1),
+	  m_repetitionFilter(),
+	  m_hasBitboards(false),
+	  m_bitboards()
 {
 	Q_ASSERT(zobrist != nullptr);
 
@@ -116,10 +124,24 @@ void Board::initialize()
 	m_initialized = true;
 	m_width = width();
 	m_height = height();
+	if (m_width == 8 && m_height == 8)
+		m_geometry = Board8x8;
+	else if (m_width == 10 && m_height == 8)
+		m_geometry = Board10x8;
+	else
+		m_geometry = AnyGeometry;
 	for (int i = 0; i < (m_width + 2) * (m_height + 4); i++)
 		m_squares.append(Piece::WallPiece);
+	m_pieceIndex.resize(m_squares.size());
 	vInitialize();
 
+	for (int i = 0; i < 2; i++)
+	{
+		m_pieceSquares[i].clear();
+		m_pieceCount[i].resize(m_pieceData.size());
+		std::fill(m_pieceCount[i].begin(), m_pieceCount[i].end(), 0);
+	}
+
 	m_maxPieceSymbolLength = 1;
 	for (const PieceData& pd: m_pieceData)
 		if (pd.symbol.length() > m_maxPieceSymbolLength)
@@ -185,6 +207,45 @@ Piece Board::pieceFromSymbol(const QString& pieceSymbol) const
 	return Piece(side.opposite(), code);
 }
 
+Piece Board::pieceFromSymbol(const char* pieceSymbol, int length) const
+{
+	if (length <= 0)
+		return Piece::NoPiece;
+
+	int code = Piece::NoPiece;
+	bool isUpper = true;
+	for (int i = 1; i < m_pieceData.size() && code == Piece::NoPiece; i++)
+	{
+		const QString& symbol = m_pieceData[i].symbol;
+		if (symbol.size() != length)
+			continue;
+
+		int j = 0;
+		for (; j < length; j++)
+		{
+			QChar c(QLatin1Char(pieceSymbol[j]));
+			if (c.toUpper() != symbol.at(j))
+				break;
+		}
+		if (j == length)
+			code = i;
+	}
+	if (code == Piece::NoPiece)
+		return code;
+
+	for (int i = 0; i < length; i++)
+	{
+		QChar c(QLatin1Char(pieceSymbol[i]));
+		if (c.toUpper() != c)
+			isUpper = false;
+	}
+
+	Side side(upperCaseSide());
+	if (isUpper)
+		return Piece(side, code);
+	return Piece(side.opposite(), code);
+}
+
 QString Board::pieceString(int pieceType) const
 {
 	if (pieceType <= 0 || pieceType >= m_pieceData.size())
@@ -240,8 +301,54 @@ void Board::removeFromReserve(const Piece& piece)
 	xorKey(m_zobrist->reservePiece(piece, --count));
 }
 
+bool Board::enableBitboards()
+{
+	if (m_width != 8 || m_height != 8
+	||  m_pieceData.size() > BitboardPieceTypes)
+		return false;
+
+	BitboardAttacks::initialize();
+	m_hasBitboards = true;
+	return true;
+}
+
+Bitboard Board::movementBitboard(Side side, unsigned movement) const
+{
+	Bitboard bb = 0;
+	for (int type = 1; type < m_pieceData.size(); type++)
+	{
+		if (m_pieceData[type].movement & movement)
+			bb |= m_bitboards.type[type];
+	}
+	return bb & m_bitboards.side[side];
+}
+
+template<class Geometry>
+static inline Square geometrySquare(int index)
+{
+	return Square(Geometry::file(index), Geometry::rank(index));
+}
+
+template<class Geometry>
+static inline int geometryIndex(const Square& square)
+{
+	if (!Geometry::isValidSquare(square.file(), square.rank()))
+		return 0;
+	return Geometry::squareIndex(square.file(), square.rank());
+}
+
 Square Board::chessSquare(int index) const
 {
+	switch (m_geometry)
+	{
+	case Board8x8:
+		return geometrySquare<Geometry8x8>(index);
+	case Board10x8:
+		return geometrySquare<Geometry10x8>(index);
+	default:
+		break;
+	}
+
 	int arwidth = m_width + 2;
 	int file = (index % arwidth) - 1;
 	int rank = (m_height - 1) - ((index / arwidth) - 2);
@@ -250,6 +357,16 @@ Square Board::chessSquare(int index) const
 
 int Board::squareIndex(const Square& square) const
 {
+	switch (m_geometry)
+	{
+	case Board8x8:
+		return geometryIndex<Geometry8x8>(square);
+	case Board10x8:
+		return geometryIndex<Geometry10x8>(square);
+	default:
+		break;
+	}
+
 	if (!isValidSquare(square))
 		return 0;
 
@@ -259,6 +376,16 @@ int Board::squareIndex(const Square& square) const
 
 bool Board::isValidSquare(const Chess::Square& square) const
 {
+	switch (m_geometry)
+	{
+	case Board8x8:
+		return Geometry8x8::isValidSquare(square.file(), square.rank());
+	case Board10x8:
+		return Geometry10x8::isValidSquare(square.file(), square.rank());
+	default:
+		break;
+	}
+
 	if (!square.isValid()
 	||  square.file() >= m_width || square.rank() >= m_height)
 		return false;
@@ -291,6 +418,24 @@ QString Board::squareString(const Square& square) const
 	return str;
 }
 
+void Board::appendSquareString(FenBuffer& buffer, int index) const
+{
+	Square square(chessSquare(index));
+	if (!square.isValid())
+		return;
+
+	if (coordinateSystem() == NormalCoordinates)
+	{
+		buffer.append(char('a' + square.file()));
+		buffer.appendNumber(square.rank() + 1);
+	}
+	else
+	{
+		buffer.appendNumber(m_width - square.file());
+		buffer.append(char('a' + (m_height - square.rank()) - 1));
+	}
+}
+
 Square Board::chessSquare(const QString& str) const
 {
 	if (str.length() < 2)
@@ -317,6 +462,54 @@ Square Board::chessSquare(const QString& str) const
 	return Square(file, rank);
 }
 
+Square Board::chessSquare(const char* str, int length) const
+{
+	if (length < 2)
+		return Square();
+
+	// Parses a decimal number like QString::toInt() does
+	auto toInt = [](const char* num, int len, bool* ok)
+	{
+		int i = 0;
+		bool negative = false;
+		if (len > 0 && (num[0] == '+' || num[0] == '-'))
+		{
+			negative = (num[0] == '-');
+			i++;
+		}
+		*ok = (i < len);
+
+		int value = 0;
+		for (; i < len && *ok; i++)
+		{
+			if (num[i] < '0' || num[i] > '9')
+				*ok = false;
+			value = value * 10 + (num[i] - '0');
+		}
+		return negative ? -value : value;
+	};
+
+	bool ok = false;
+	int file = 0;
+	int rank = 0;
+
+	if (coordinateSystem() == NormalCoordinates)
+	{
+		file = str[0] - 'a';
+		rank = toInt(str + 1, length - 1, &ok) - 1;
+	}
+	else
+	{
+		int tmp = length - 1;
+		file = m_width - toInt(str, tmp, &ok);
+		rank = m_height - (str[tmp] - 'a') - 1;
+	}
+
+	if (!ok)
+		return Square();
+	return Square(file, rank);
+}
+
 int Board::squareIndex(const QString& str) const
 {
 	return squareIndex(chessSquare(str));
@@ -350,68 +543,101 @@ QString Board::moveString(const Move& move, MoveNotation notation)
 	return lanMoveString(move);
 }
 
-QString Board::sanStringForPv(const QString& pv, MoveNotation notation)
+QString Board::moveSequenceString(const QVector<Move>& moves,
+				 MoveNotation notation)
 {
 	QString str;
-	int made = 0;
-	int i;
+	for (int i = 0; i < moves.size(); i++)
+	{
+		if (i > 0)
+			str += QLatin1Char(' ');
+		str += moveString(moves.at(i), notation);
+		makeMove(moves.at(i));
+	}
+	for (int i = 0; i < moves.size(); i++)
+		undoMove();
 
-	if (notation == StandardAlgebraic) {
-		QStringList strList = pv.split(' ');
-		if (strList.isEmpty())
-			return str;
+	return str;
+}
 
-		for (i = 0; i < strList.length(); i++)
-		{
-			QString token = strList.at(i);
-			if (!token.length())
-				break;
-			Move move = moveFromString(token);
-			if (move.isNull())
-				break;
-			str += (made > 0) ? " " : "";
-			str += sanMoveString(move);
-			makeMove(move);
-			made++;
-		}
-		for (i = 0; i < made; i++) {
-			undoMove();
-		}
+QString Board::sanStringForPv(const QString& pv, MoveNotation notation)
+{
+	if (notation != StandardAlgebraic)
+		return QString();
+
+	QVector<Move> moves;
+	const QStringList strList = pv.split(' ');
+	for (const QString& token : strList)
+	{
+		if (token.isEmpty())
+			break;
+		Move move = moveFromString(token);
+		if (move.isNull())
+			break;
+		moves.append(move);
+		makeMove(move);
 	}
-	return str;
+	for (int i = 0; i < moves.size(); i++)
+		undoMove();
+
+	return moveSequenceString(moves, notation);
+}
+
+void Board::toMoveBytes(const QString& str, MoveBytes& bytes)
+{
+	bytes.resize(str.size());
+	for (int i = 0; i < str.size(); i++)
+		bytes[i] = str.at(i).toLatin1();
 }
 
-Move Board::moveFromLanString(const QString& istr)
+Move Board::moveFromLanString(const QString& str)
 {
-	QString str(istr);
-	str.remove(QRegExp("[x+#!?]"));
-	int len = str.length();
+	MoveBytes bytes;
+	toMoveBytes(str, bytes);
+	return Board::moveFromLanBytes(bytes.constData(), bytes.size());
+}
+
+Move Board::moveFromLanBytes(const char* istr, int length)
+{
+	// Ignore capture, check/mate and strong move/blunder marks
+	MoveBytes str;
+	int drop = -1;
+	for (int i = 0; i < length; i++)
+	{
+		char c = istr[i];
+		if (c == 'x' || c == '+' || c == '#' || c == '!' || c == '?')
+			continue;
+		if (c == '@' && drop == -1)
+			drop = str.size();
+		str.append(c);
+	}
+	int len = str.size();
 	if (len < 4)
 		return Move();
 
 	Piece promotion;
-	int drop = str.indexOf('@');
 	if (drop > 0)
 	{
-		promotion = pieceFromSymbol(str.left(drop));
+		promotion = pieceFromSymbol(str.constData(), drop);
 		if (!promotion.isValid())
 			return Move();
-		
-		Square trg(chessSquare(str.mid(drop + 1)));
+
+		Square trg(chessSquare(str.constData() + drop + 1,
+				       len - drop - 1));
 		if (!isValidSquare(trg))
 			return Move();
-		
+
 		return Move(0, squareIndex(trg), promotion.type());
 	}
 
-	Square sourceSq(chessSquare(str.mid(0, 2)));
-	Square targetSq(chessSquare(str.mid(2, 2)));
+	Square sourceSq(chessSquare(str.constData(), 2));
+	Square targetSq(chessSquare(str.constData() + 2, 2));
 	if (!isValidSquare(sourceSq) || !isValidSquare(targetSq))
 		return Move();
 
 	if (len > 4)
 	{
-		promotion = pieceFromSymbol(str.mid(len-1));
+		promotion = pieceFromSymbol(str.constData() + len - 1, 1);
 		if (!promotion.isValid())
 			return Move();
 	}
@@ -422,6 +648,11 @@ Move Board::moveFromLanString(const QString& istr)
 	return Move(source, target, promotion.type());
 }
 
+Move Board::moveFromSanBytes(const char* str, int length)
+{
+	return moveFromSanString(QString::fromLatin1(str, length));
+}
+
 Move Board::moveFromString(const QString& str)
 {
 	Move move = moveFromSanString(str);
@@ -434,6 +665,18 @@ Move Board::moveFromString(const QString& str)
 	return move;
 }
 
+Move Board::moveFromString(const char* str, int length)
+{
+	Move move = moveFromSanBytes(str, length);
+	if (move.isNull())
+	{
+		move = moveFromLanBytes(str, length);
+		if (!isLegalMove(move))
+			return Move();
+	}
+	return move;
+}
+
 Move Board::moveFromGenericMove(const GenericMove& move) const
 {
 	int source = squareIndex(move.sourceSquare());
@@ -452,6 +695,17 @@ GenericMove Board::genericMove(const Move& move) const
 			   move.promotion());
 }
 
+quint16 Board::compactMove(const Move& move) const
+{
+	return genericMove(move).toCompact(width(), height());
+}
+
+Move Board::moveFromCompact(quint16 move) const
+{
+	return moveFromGenericMove(GenericMove::fromCompact(move, width(),
+							    height()));
+}
+
 QStringList Board::pieceList(Side side) const
 {
 	QStringList list;
@@ -470,9 +724,86 @@ QStringList Board::pieceList(Side side) const
 	return list;
 }
 
+Board::FenBuffer::FenBuffer(char* data, int size)
+	: m_data(data),
+	  m_size(size),
+	  m_length(0)
+{
+}
+
+int Board::FenBuffer::length() const
+{
+	return m_length;
+}
+
+bool Board::FenBuffer::isValid() const
+{
+	return m_length <= m_size;
+}
+
+void Board::FenBuffer::append(char c)
+{
+	if (m_length < m_size)
+		m_data[m_length] = c;
+	m_length++;
+}
+
+void Board::FenBuffer::append(const QString& str)
+{
+	for (const QChar& c : str)
+		append(c.toLatin1());
+}
+
+void Board::FenBuffer::appendNumber(int number)
+{
+	if (number < 0)
+	{
+		append('-');
+		number = -number;
+	}
+
+	char digits[12];
+	int n = 0;
+	do
+	{
+		digits[n++] = char('0' + number % 10);
+		number /= 10;
+	} while (number > 0);
+
+	while (n > 0)
+		append(digits[--n]);
+}
+
+void Board::appendPieceSymbol(FenBuffer& buffer, Piece piece) const
+{
+	int type = piece.type();
+	if (type <= 0 || type >= m_pieceData.size())
+		return;
+
+	const QString& symbol = m_pieceData[type].symbol;
+	bool upper = (piece.side() == upperCaseSide());
+	for (const QChar& c : symbol)
+		buffer.append(upper ? c.toLatin1() : c.toLower().toLatin1());
+}
+
+void Board::vFenBytes(FenBuffer& buffer, FenNotation notation) const
+{
+	buffer.append(vFenString(notation));
+}
+
 QString Board::fenString(FenNotation notation) const
 {
-	QString fen;
+	QVarLengthArray<char, 256> buffer(256);
+	int length;
+	while ((length = fenString(buffer.data(), buffer.size(), notation)) < 0)
+		buffer.resize(buffer.size() * 2);
+
+	return QString::fromLatin1(buffer.constData(), length);
+}
+
+int Board::fenString(char* buffer, int size, FenNotation notation) const
+{
+	FenBuffer fen(buffer, size);
 
 	// Squares
 	int i = (m_width + 2) * 2;
@@ -481,7 +812,7 @@ QString Board::fenString(FenNotation notation) const
 		int nempty = 0;
 		i++;
 		if (y > 0)
-			fen += '/';
+			fen.append('/');
 		for (int x = 0; x < m_width; x++)
 		{
 			Piece pc = m_squares[i];
@@ -494,12 +825,12 @@ QString Board::fenString(FenNotation notation) const
 			if (nempty > 0
 			&&  (!pc.isEmpty() || x == m_width - 1))
 			{
-				fen += QString::number(nempty);
+				fen.appendNumber(nempty);
 				nempty = 0;
 			}
 
 			if (pc.isValid())
-				fen += pieceSymbol(pc);
+				appendPieceSymbol(fen, pc);
 			i++;
 		}
 		i++;
@@ -508,7 +839,8 @@ QString Board::fenString(FenNotation notation) const
 	// Hand pieces
 	if (variantHasDrops())
 	{
-		QString str;
+		fen.append('[');
+		int start = fen.length();
 		for (i = Side::White; i <= Side::Black; i++)
 		{
 			Side side = Side::Type(i);
@@ -516,55 +848,108 @@ QString Board::fenString(FenNotation notation) const
 			{
 				int count = m_reserve[i].at(j);
 				for (int k = 0; k < count; k++)
-					str += pieceSymbol(Piece(side, j));
+					appendPieceSymbol(fen, Piece(side, j));
 			}
 		}
-		if (str.isEmpty())
-			str = "-";
-		fen += QString("[%1]").arg(str);
+		if (fen.length() == start)
+			fen.append('-');
+		fen.append(']');
 	}
 
 	// Side to move
-	fen += QString(" %1 ").arg(m_side.symbol());
+	fen.append(' ');
+	if (m_side == Side::White)
+		fen.append('w');
+	else if (m_side == Side::Black)
+		fen.append('b');
+	fen.append(' ');
+
+	vFenBytes(fen, notation);
+
+	// Null terminator
+	int length = fen.length();
+	fen.append('\0');
+	if (!fen.isValid())
+		return -1;
+	return length;
+}
 
-	return fen + vFenString(notation);
+void Board::clearPosition()
+{
+	for (int i = 0; i < m_squares.size(); i++)
+		m_squares[i] = Piece::WallPiece;
+	for (int i = 0; i < 2; i++)
+	{
+		m_pieceSquares[i].clear();
+		std::fill(m_pieceCount[i].begin(), m_pieceCount[i].end(), 0);
+	}
+	m_bitboards = Bitboards();
+	m_key = 0;
+	m_reserve[Side::White].clear();
+	m_reserve[Side::Black].clear();
 }
 
-bool Board::setFenString(const QString& fen)
+bool Board::finishPosition(Side side, const QStringList& fen)
 {
-	QStringList strList = fen.split(' ');
-	if (strList.isEmpty())
+	m_side = side;
+	m_startingSide = m_side;
+	if (m_side.isNull())
+		return false;
+
+	m_moveHistory.clear();
+	m_legalMovePly = -1;
+	std::fill(m_repetitionFilter,
+		  m_repetitionFilter + RepetitionFilterSize, 0);
+
+	// Let subclasses handle the rest of the FEN string
+	if (!vSetFenString(fen))
+		return false;
+
+	if (m_side == Side::White)
+		xorKey(m_zobrist->side());
+
+	if (!isLegalPosition())
 		return false;
 
-	QStringList::iterator token = strList.begin();
-	if (token->length() < m_height * 2)
+	return true;
+}
+
+bool Board::setFenString(const QString& fen)
+{
+	QVarLengthArray<char, 128> bytes(fen.size());
+	for (int i = 0; i < fen.size(); i++)
+		bytes[i] = fen.at(i).toLatin1();
+
+	return setFenString(bytes.constData(), bytes.size());
+}
+
+bool Board::setFenString(const char* fen, int length)
+{
+	// The first field holds the squares and hand pieces
+	const char* end = fen + length;
+	const char* tokenEnd = std::find(fen, end, ' ');
+	const int tokenLength = int(tokenEnd - fen);
+	if (tokenLength < m_height * 2)
 		return false;
 
 	initialize();
+	clearPosition();
 
 	int square = 0;
 	int rankEndSquare = 0;	// last square of the previous rank
 	int boardSize = m_width * m_height;
 	int k = (m_width + 2) * 2 + 1;
 
-	for (int i = 0; i < m_squares.size(); i++)
-		m_squares[i] = Piece::WallPiece;
-	m_key = 0;
-
 	// Get the board contents (squares)
 	int handPieceIndex = -1;
 	int maxsymlen = maxPieceSymbolLength();
-	QString pieceStr;
-	for (int i = 0; i < token->length(); i++)
+	for (int i = 0; i < tokenLength; i++)
 	{
-		QChar c = token->at(i);
+		char c = fen[i];
 
 		// Move to the next rank
 		if (c == '/')
 		{
-			if (!pieceStr.isEmpty())
-				return false;
-
 			// Reject the FEN string if the rank didn't
 			// have exactly 'm_width' squares.
 			if (square - rankEndSquare != m_width)
@@ -582,24 +967,19 @@ bool Board::setFenString(const QString& fen)
 			break;
 		}
 		// Add empty squares
-		if (c.isDigit())
+		if (c >= '0' && c <= '9')
 		{
-			if (!pieceStr.isEmpty())
-				return false;
-
-			int j;
-			int nempty;
-			if (i < (token->length() - 1) && token->at(i + 1).isDigit())
+			int nempty = c - '0';
+			if (i < tokenLength - 1
+			&&  fen[i + 1] >= '0' && fen[i + 1] <= '9')
 			{
-				nempty = token->midRef(i, 2).toInt();
+				nempty = nempty * 10 + (fen[i + 1] - '0');
 				i++;
 			}
-			else
-				nempty = c.digitValue();
 
 			if (nempty > m_width || square + nempty > boardSize)
 				return false;
-			for (j = 0; j < nempty; j++)
+			for (int j = 0; j < nempty; j++)
 			{
 				square++;
 				setSquare(k++, Piece::NoPiece);
@@ -611,21 +991,21 @@ bool Board::setFenString(const QString& fen)
 			return false;
 
 		// read ahead for multi-character symbols
-		for (int l = qMin(maxsymlen, token->length() - i); l > 0; l--)
+		bool found = false;
+		for (int l = qMin(maxsymlen, tokenLength - i); l > 0; l--)
 		{
-			pieceStr = token->mid(i, l);
-			Piece piece = pieceFromSymbol(pieceStr);
+			Piece piece = pieceFromSymbol(fen + i, l);
 			if (piece.isValid())
 			{
 				setSquare(k++, piece);
 				i += l - 1;
-				pieceStr.clear();
 				square++;
+				found = true;
 				break;
 			}
 		}
 		// left over: unknown symbols
-		if (!pieceStr.isEmpty())
+		if (!found)
 			return false;
 	}
 
@@ -635,30 +1015,28 @@ bool Board::setFenString(const QString& fen)
 		return false;
 
 	// Hand pieces
-	m_reserve[Side::White].clear();
-	m_reserve[Side::Black].clear();
 	if (handPieceIndex != -1)
 	{
-		for (int i = handPieceIndex; i < token->length(); i++)
+		for (int i = handPieceIndex; i < tokenLength; i++)
 		{
-			QChar c = token->at(i);
+			char c = fen[i];
 			if (c == ']')
 				break;
 			if (c == '-' && i == handPieceIndex)
 				continue;
 
 			int count = 1;
-			if (c.isDigit())
+			if (c >= '0' && c <= '9')
 			{
-				count = c.digitValue();
+				count = c - '0';
 				if (count <= 0)
 					return false;
 				++i;
-				if (i >= token->length() - 1)
+				if (i >= tokenLength - 1)
 					return false;
-				c = token->at(i);
+				c = fen[i];
 			}
-			Piece tmp = pieceFromSymbol(c);
+			Piece tmp = pieceFromSymbol(&c, 1);
 			if (!tmp.isValid())
 				return false;
 			addToReserve(tmp, count);
@@ -666,29 +1044,208 @@ bool Board::setFenString(const QString& fen)
 	}
 
 	// Side to move
-	if (++token == strList.end())
-		return false;
-	m_side = Side(*token);
-	m_startingSide = m_side;
-	if (m_side.isNull())
+	if (tokenEnd == end)
 		return false;
+	const char* sideStr = tokenEnd + 1;
+	tokenEnd = std::find(sideStr, end, ' ');
+	Side side;
+	if (tokenEnd - sideStr == 1 && *sideStr == 'w')
+		side = Side::White;
+	else if (tokenEnd - sideStr == 1 && *sideStr == 'b')
+		side = Side::Black;
+
+	// The remaining fields are split like QString::split() does
+	QStringList tail;
+	if (tokenEnd != end)
+	{
+		const char* token = tokenEnd + 1;
+		for (;;)
+		{
+			tokenEnd = std::find(token, end, ' ');
+			tail.append(QString::fromLatin1(token, int(tokenEnd - token)));
+			if (tokenEnd == end)
+				break;
+			token = tokenEnd + 1;
+		}
+	}
 
-	m_moveHistory.clear();
-	m_startingFen = fen;
+	m_startingFen = QString::fromLatin1(fen, length);
+	return finishPosition(side, tail);
+}
 
-	// Let subclasses handle the rest of the FEN string
-	if (token != strList.end())
-		++token;
-	strList.erase(strList.begin(), token);
-	if (!vSetFenString(strList))
-		return false;
+int Board::packedPosition(char* buffer, int size) const
+{
+	// Layout:
+	//   flags:  bit 0 is set if Black is to move, bit 1 is set if
+	//           pieces take a full byte instead of a nibble
+	//   bitmap: one bit per square in FEN order
+	//   pieces: (side << 3 | type) nibbles, or (side << 7 | type)
+	//           bytes, for each occupied square in FEN order
+	//   hand:   (type, count) byte pairs for White and Black, each
+	//           list terminated by a zero byte (drop variants only)
+	//   rest:   the variant specific FEN fields as Latin-1 text
+	const int boardSize = m_width * m_height;
+	const int bitmapSize = (boardSize + 7) / 8;
+	if (size < 1 + bitmapSize)
+		return -1;
+
+	bool wide = (m_pieceData.size() > 8);
+	unsigned char* out = reinterpret_cast<unsigned char*>(buffer);
+	out[0] = (m_side == Side::Black ? 1 : 0) | (wide ? 2 : 0);
+	std::fill(out + 1, out + 1 + bitmapSize, 0);
+
+	int pos = 1 + bitmapSize;
+	int nibbles = 0;
+	int square = 0;
+	int k = (m_width + 2) * 2 + 1;
+	for (int y = 0; y < m_height; y++, k += 2)
+	{
+		for (int x = 0; x < m_width; x++, k++, square++)
+		{
+			Piece pc = m_squares[k];
+			if (!pc.isValid())
+				continue;
 
-	if (m_side == Side::White)
-		xorKey(m_zobrist->side());
+			out[1 + square / 8] |= 1 << (square % 8);
+			int sideBit = (pc.side() == Side::Black);
+			if (wide)
+			{
+				if (pos >= size)
+					return -1;
+				out[pos++] = (sideBit << 7) | pc.type();
+			}
+			else if (nibbles++ % 2 == 0)
+			{
+				if (pos >= size)
+					return -1;
+				out[pos++] = (sideBit << 3) | pc.type();
+			}
+			else
+				out[pos - 1] |= ((sideBit << 3) | pc.type()) << 4;
+		}
+	}
 
-	if (!isLegalPosition())
+	if (variantHasDrops())
+	{
+		for (int i = Side::White; i <= Side::Black; i++)
+		{
+			for (int j = 1; j < m_reserve[i].size(); j++)
+			{
+				int count = m_reserve[i].at(j);
+				if (count <= 0)
+					continue;
+				if (pos + 2 > size)
+					return -1;
+				out[pos++] = j;
+				out[pos++] = qMin(count, 255);
+			}
+			if (pos >= size)
+				return -1;
+			out[pos++] = 0;
+		}
+	}
+
+	FenBuffer rest(buffer + pos, size - pos);
+	vFenBytes(rest, XFen);
+	if (!rest.isValid())
+		return -1;
+
+	return pos + rest.length();
+}
+
+bool Board::setPackedPosition(const char* data, int length)
+{
+	const int boardSize = m_width * m_height;
+	const int bitmapSize = (boardSize + 7) / 8;
+	if (length < 1 + bitmapSize)
 		return false;
 
+	initialize();
+	clearPosition();
+
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+	Side side = (in[0] & 1) ? Side::Black : Side::White;
+	bool wide = (in[0] & 2);
+
+	int pos = 1 + bitmapSize;
+	int nibbles = 0;
+	int square = 0;
+	int k = (m_width + 2) * 2 + 1;
+	for (int y = 0; y < m_height; y++, k += 2)
+	{
+		for (int x = 0; x < m_width; x++, k++, square++)
+		{
+			if (!(in[1 + square / 8] & (1 << (square % 8))))
+			{
+				setSquare(k, Piece::NoPiece);
+				continue;
+			}
+
+			int code;
+			if (wide)
+			{
+				if (pos >= length)
+					return false;
+				code = in[pos++];
+				code = ((code & 0x80) ? 0x100 : 0) | (code & 0x7f);
+			}
+			else if (nibbles++ % 2 == 0)
+			{
+				if (pos >= length)
+					return false;
+				code = in[pos++] & 0x0f;
+				code = ((code & 8) ? 0x100 : 0) | (code & 7);
+			}
+			else
+			{
+				code = in[pos - 1] >> 4;
+				code = ((code & 8) ? 0x100 : 0) | (code & 7);
+			}
+
+			int type = code & 0xff;
+			if (type <= 0 || type >= m_pieceData.size())
+				return false;
+			setSquare(k, Piece((code & 0x100) ? Side::Black : Side::White,
+					   type));
+		}
+	}
+
+	if (variantHasDrops())
+	{
+		for (int i = Side::White; i <= Side::Black; i++)
+		{
+			for (;;)
+			{
+				if (pos >= length)
+					return false;
+				int type = in[pos++];
+				if (type == 0)
+					break;
+				if (type >= m_pieceData.size() || pos >= length)
+					return false;
+				addToReserve(Piece(Side::Type(i), type), in[pos++]);
+			}
+		}
+	}
+
+	QStringList tail;
+	const char* end = data + length;
+	const char* token = data + pos;
+	if (token != end)
+	{
+		for (;;)
+		{
+			const char* tokenEnd = std::find(token, end, ' ');
+			tail.append(QString::fromLatin1(token, int(tokenEnd - token)));
+			if (tokenEnd == end)
+				break;
+			token = tokenEnd + 1;
+		}
+	}
+
+	if (!finishPosition(side, tail))
+		return false;
+	m_startingFen = fenString();
 	return true;
 }
 
@@ -702,13 +1259,16 @@ void Board::makeMove(const Move& move, BoardTransition* transition)
 	Q_ASSERT(!m_side.isNull());
 	Q_ASSERT(!move.isNull());
 
-	MoveData md = { move, m_key };
+	MoveState md;
+	md.move = move;
+	md.key = m_key;
+	m_moveHistory.append(md);
 
 	vMakeMove(move, transition);
 
 	xorKey(m_zobrist->side());
 	m_side = m_side.opposite();
-	m_moveHistory << md;
+	m_repetitionFilter[md.key & (RepetitionFilterSize - 1)]++;
 }
 
 void Board::undoMove()
@@ -720,31 +1280,41 @@ void Board::undoMove()
 	vUndoMove(m_moveHistory.last().move);
 
 	m_key = m_moveHistory.last().key;
-	m_moveHistory.pop_back();
+	m_repetitionFilter[m_key & (RepetitionFilterSize - 1)]--;
+	m_moveHistory.removeLast();
 }
 
-void Board::generateMoves(QVarLengthArray<Move>& moves, int pieceType) const
+void Board::generateMoves(MoveList& moves, int pieceType) const
 {
 	Q_ASSERT(!m_side.isNull());
 
-	// Cut the wall squares (the ones with a value of WallPiece) off
-	// from the squares to iterate over. It bumps the speed up a bit.
-	unsigned begin = (m_width + 2) * 2;
-	unsigned end = m_squares.size() - begin;
-
 	moves.clear();
-	for (unsigned sq = begin; sq < end; sq++)
+	if (m_hasBitboards)
+	{
+		Bitboard pieces = m_bitboards.side[m_side];
+		if (pieceType != Piece::NoPiece)
+			pieces &= m_bitboards.type[pieceType];
+		while (pieces)
+		{
+			int sq = BitboardAttacks::toIndex(BitboardAttacks::popLsb(pieces));
+			generateMovesForPiece(moves, m_squares[sq].type(), sq);
+		}
+
+		generateDropMoves(moves, pieceType);
+		return;
+	}
+
+	for (const int sq: m_pieceSquares[m_side])
 	{
-		Piece tmp = m_squares[sq];
-		if (tmp.side() == m_side
-		&&  (pieceType == Piece::NoPiece || tmp.type() == pieceType))
-			generateMovesForPiece(moves, tmp.type(), sq);
+		int type = m_squares[sq].type();
+		if (pieceType == Piece::NoPiece || type == pieceType)
+			generateMovesForPiece(moves, type, sq);
 	}
 
 	generateDropMoves(moves, pieceType);
 }
 
-void Board::generateDropMoves(QVarLengthArray<Move>& moves, int pieceType) const
+void Board::generateDropMoves(MoveList& moves, int pieceType) const
 {
 	const QVector<int>& pieces(m_reserve[m_side]);
 	if (pieces.isEmpty())
@@ -764,8 +1334,8 @@ void Board::generateDropMoves(QVarLengthArray<Move>& moves, int pieceType) const
 }
 
 void Board::generateHoppingMoves(int sourceSquare,
-				 const QVarLengthArray<int>& offsets,
-				 QVarLengthArray<Move>& moves) const
+				 const QVector<int>& offsets,
+				 MoveList& moves) const
 {
 	Side opSide = sideToMove().opposite();
 	for (int i = 0; i < offsets.size(); i++)
@@ -780,8 +1350,8 @@ void Board::generateHoppingMoves(int sourceSquare,
 }
 
 void Board::generateSlidingMoves(int sourceSquare,
-				 const QVarLengthArray<int>& offsets,
-				 QVarLengthArray<Move>& moves) const
+				 const QVector<int>& offsets,
+				 MoveList& moves) const
 {
 	Side side = sideToMove();
 	for (int i = 0; i < offsets.size(); i++)
@@ -805,7 +1375,7 @@ bool Board::moveExists(const Move& move) const
 	Q_ASSERT(!move.isNull());
 
 	int source = move.sourceSquare();
-	QVarLengthArray<Move> moves;
+	MoveList moves;
 
 	if (source == 0)
 		generateDropMoves(moves, move.promotion());
@@ -846,18 +1416,63 @@ bool Board::vIsLegalMove(const Move& move)
 	return isLegal;
 }
 
+bool Board::hasLegalMoveCache() const
+{
+	return m_legalMovePly == plyCount() && m_legalMoveKey == m_key;
+}
+
 bool Board::isLegalMove(const Move& move)
 {
-	return !move.isNull() && moveExists(move) && vIsLegalMove(move);
+	if (move.isNull())
+		return false;
+
+	if (hasLegalMoveCache())
+	{
+		for (int i = 0; i < m_legalMoveCache.size(); i++)
+		{
+			if (m_legalMoveCache[i] == move)
+				return true;
+		}
+		return false;
+	}
+
+	return moveExists(move) && vIsLegalMove(move);
+}
+
+quint64 Board::materialKey() const
+{
+	// 64-bit FNV-1a over the piece counts
+	quint64 key = Q_UINT64_C(0xcbf29ce484222325);
+	for (int side = 0; side < 2; side++)
+	{
+		for (int count : m_pieceCount[side])
+		{
+			key ^= quint64(count);
+			key *= Q_UINT64_C(0x100000001b3);
+		}
+	}
+
+	return key;
 }
 
 int Board::repeatCount() const
 {
-	if (plyCount() < 4)
+	int plies = plyCount();
+	if (plies < 4
+	||  m_repetitionFilter[m_key & (RepetitionFilterSize - 1)] == 0)
 		return 0;
 
+	// A position can't occur again after an irreversible move,
+	// except in drop variants where captured pieces can return
+	// to the board.
+	int window = reversibleMoveCount();
+	if (window < 0 || window > plies || variantHasDrops())
+		window = plies;
+
+	// The side to move is part of the key, so only every
+	// other position needs to be compared.
 	int repeatCount = 0;
-	for (int i = plyCount() - 1; i >= 0; i--)
+	for (int i = plies - 2; i >= plies - window; i -= 2)
 	{
 		if (m_moveHistory.at(i).key == m_key)
 			repeatCount++;
@@ -884,7 +1499,10 @@ bool Board::isRepetition(const Chess::Move& move)
 
 bool Board::canMove()
 {
-	QVarLengthArray<Move> moves;
+	if (hasLegalMoveCache())
+		return !m_legalMoveCache.isEmpty();
+
+	MoveList moves;
 	generateMoves(moves);
 
 	for (int i = 0; i < moves.size(); i++)
@@ -896,19 +1514,41 @@ bool Board::canMove()
 	return false;
 }
 
-QVector<Move> Board::legalMoves()
+void Board::legalMoves(MoveList& moves)
 {
-	QVarLengthArray<Move> moves;
-	QVector<Move> legalMoves;
-
 	generateMoves(moves);
-	legalMoves.reserve(moves.size());
 
-	for (int i = moves.size() - 1; i >= 0; i--)
+	// Drop the illegal moves in place
+	int count = 0;
+	for (int i = 0; i < moves.size(); i++)
 	{
 		if (vIsLegalMove(moves[i]))
-			legalMoves << moves[i];
+			moves[count++] = moves[i];
 	}
+	moves.resize(count);
+}
+
+void Board::cacheLegalMoves()
+{
+	if (hasLegalMoveCache())
+		return;
+
+	// Invalidate the old list while the new one is generated
+	m_legalMovePly = -1;
+	legalMoves(m_legalMoveCache);
+	m_legalMoveKey = m_key;
+	m_legalMovePly = plyCount();
+}
+
+QVector<Move> Board::legalMoves()
+{
+	MoveList moves;
+	legalMoves(moves);
+
+	QVector<Move> legalMoves;
+	legalMoves.reserve(moves.size());
+	for (int i = moves.size() - 1; i >= 0; i--)
+		legalMoves << moves[i];
 
 	return legalMoves;
 }
@@ -919,4 +1559,9 @@ Result Board::tablebaseResult(unsigned int* dtm) const
 	return Result();
 }
 
+Result Board::tablebaseWdlResult() const
+{
+	return Result();
+}
+
 } // namespace Chess
@@ -27,9 +27,11 @@
 #include "square.h"
 #include "piece.h"
 #include "move.h"
+#include "movestate.h"
 #include "genericmove.h"
 #include "zobrist.h"
 #include "result.h"
+#include "bitboard.h"
 class QStringList;
 
 
@@ -153,6 +155,14 @@ class LIB_EXPORT Board
 		virtual QString defaultFenString() const = 0;
 		/*! Returns the zobrist key for the current position. */
 		quint64 key() const;
+		/*!
+		 * Returns a signature of the material on the board.
+		 *
+		 * The signature depends only on the number of pieces of each
+		 * type and side, so it changes exactly when a piece is
+		 * captured, promoted or dropped.
+		 */
+		quint64 materialKey() const;
 		/*!
 		 * Initializes the board.
 		 * This function must be called before a game can be started
@@ -186,6 +196,45 @@ class LIB_EXPORT Board
 		 * Returns true if successful; otherwise returns false.
 		 */
 		bool setFenString(const QString& fen);
+		/*!
+		 * Writes the FEN string of the current board position to
+		 * \a buffer, which can hold \a size bytes.
+		 *
+		 * The string is Latin-1 encoded and null-terminated. Returns
+		 * the length of the string, or -1 if it doesn't fit.
+		 */
+		int fenString(char* buffer,
+			      int size,
+			      FenNotation notation = XFen) const;
+		/*!
+		 * Sets the board position according to a Latin-1 FEN string
+		 * of \a length bytes.
+		 *
+		 * Returns true if successful; otherwise returns false.
+		 */
+		bool setFenString(const char* fen, int length);
+		/*! The maximum size of a packed position in bytes. */
+		static const int MaxPackedPositionSize = 512;
+		/*!
+		 * Writes the current board position to \a buffer, which can
+		 * hold \a size bytes, in a compact binary format.
+		 *
+		 * The format stores the squares as an occupancy bitmap
+		 * followed by a nibble (or a byte) per piece, the hand
+		 * pieces as (type, count) pairs, and the variant specific
+		 * part of the FEN string as text. Returns the size of the
+		 * data, or -1 if it doesn't fit.
+		 *
+		 * \sa setPackedPosition()
+		 */
+		int packedPosition(char* buffer, int size) const;
+		/*!
+		 * Sets the board position from \a length bytes of \a data
+		 * written by packedPosition() for the same variant.
+		 *
+		 * Returns true if successful; otherwise returns false.
+		 */
+		bool setPackedPosition(const char* data, int length);
 		/*!
 		 * Sets the board position to the default starting position
 		 * of the chess variant.
@@ -208,6 +257,10 @@ class LIB_EXPORT Board
 		/*!
 		 * Returns the number of times the current position was
 		 * reached previously in the game.
+		 *
+		 * Only the positions since the last irreversible move are
+		 * considered, unless the variant has piece drops.
+		 * \sa reversibleMoveCount()
 		 */
 		int repeatCount() const;
 		/*!
@@ -223,10 +276,23 @@ class LIB_EXPORT Board
 		 * always returns 0.
 		 */
 		int reserveCount(Piece piece) const;
+		/*!
+		 * Returns the number of pieces of type \a pieceType that
+		 * \a side has on the board.
+		 *
+		 * If \a pieceType is Piece::NoPiece (default), the number of
+		 * all pieces of \a side on the board is returned.
+		 */
+		int pieceCount(Side side, int pieceType = Piece::NoPiece) const;
 		/*! Converts \a piece into a piece symbol. */
 		QString pieceSymbol(Piece piece) const;
 		/*! Converts \a pieceSymbol into a Piece object. */
 		Piece pieceFromSymbol(const QString& pieceSymbol) const;
+		/*!
+		 * Converts a Latin-1 piece symbol of \a length bytes into
+		 * a Piece object.
+		 */
+		Piece pieceFromSymbol(const char* pieceSymbol, int length) const;
 		/*! Returns the internationalized name of \a pieceType. */
 		QString pieceString(int pieceType) const;
 		/*! Returns symbol for graphical representation of \a piece. */
@@ -251,6 +317,18 @@ class LIB_EXPORT Board
 		 * \sa moveFromString()
 		 */
 		QString moveString(const Move& move, MoveNotation notation);
+		/*!
+		 * Converts a sequence of legal moves into a string.
+		 *
+		 * The moves in \a moves are played from the current position
+		 * and converted one by one to \a notation. The resulting move
+		 * strings are separated by spaces. The board is restored to
+		 * its original position before returning.
+		 *
+		 * \sa moveString()
+		 */
+		virtual QString moveSequenceString(const QVector<Move>& moves,
+						   MoveNotation notation);
 		QString sanStringForPv(const QString& pv, MoveNotation notation);
 		/*!
 		 * Converts a move string into a Move.
@@ -261,6 +339,14 @@ class LIB_EXPORT Board
 		 * \sa moveString()
 		 */
 		Move moveFromString(const QString& str);
+		/*!
+		 * Converts a Latin-1 move string of \a length bytes into
+		 * a Move.
+		 *
+		 * This is the same as moveFromString(const QString&) but the
+		 * string is parsed in place when the variant allows it.
+		 */
+		Move moveFromString(const char* str, int length);
 		/*!
 		 * Converts a GenericMove into a Move.
 		 *
@@ -275,6 +361,19 @@ class LIB_EXPORT Board
 		 * \sa moveFromGenericMove()
 		 */
 		GenericMove genericMove(const Move& move) const;
+		/*!
+		 * Encodes \a move in 16 bits for this board's size.
+		 *
+		 * Returns 0 if the board has more than 128 squares.
+		 * \sa GenericMove::toCompact(), moveFromCompact()
+		 */
+		quint16 compactMove(const Move& move) const;
+		/*!
+		 * Converts a move encoded by compactMove() into a Move.
+		 *
+		 * \note The board must be in a position where \a move can be made.
+		 */
+		Move moveFromCompact(quint16 move) const;
 
 		/*! Returns true if \a move is legal in the current position. */
 		bool isLegalMove(const Move& move);
@@ -285,6 +384,24 @@ class LIB_EXPORT Board
 		bool isRepetition(const Move& move);
 		/*! Returns a vector of legal moves in the current position. */
 		QVector<Move> legalMoves();
+		/*!
+		 * Fills \a moves with the legal moves in the current position.
+		 *
+		 * Unlike the overload that returns a vector, this function
+		 * doesn't allocate memory.
+		 */
+		void legalMoves(MoveList& moves);
+		/*!
+		 * Generates the legal moves of the current position and
+		 * keeps them until the position changes.
+		 *
+		 * While the list is kept, isLegalMove(), canMove() and the
+		 * move string parsers look moves up in it instead of
+		 * validating them one by one. A game calls this once per
+		 * turn so that the side to move's reply is checked against
+		 * the list that was generated to adjudicate the position.
+		 */
+		void cacheLegalMoves();
 		/*!
 		 * Returns the result of the game, or Result::NoResult if
 		 * the game is in progress.
@@ -300,8 +417,45 @@ class LIB_EXPORT Board
 		 * The default implementation always returns a null result.
 		 */
 		virtual Result tablebaseResult(unsigned int* dtm = nullptr) const;
+		/*!
+		 * Returns the expected game result according to the
+		 * win/draw/loss endgame tables.
+		 *
+		 * This is much cheaper than tablebaseResult() because it
+		 * doesn't need the distance-to-zero tables, but it is only
+		 * exact right after a capture or a pawn move. Implementations
+		 * fall back to tablebaseResult() in other positions.
+		 *
+		 * The default implementation always returns a null result.
+		 */
+		virtual Result tablebaseWdlResult() const;
 
 	protected:
+		/*! A fixed-size output buffer for Latin-1 FEN strings. */
+		class FenBuffer
+		{
+			public:
+				/*! Creates a buffer of \a size bytes at \a data. */
+				FenBuffer(char* data, int size);
+
+				/*! Returns the number of bytes written. */
+				int length() const;
+				/*! Returns false if the buffer has overflown. */
+				bool isValid() const;
+
+				/*! Appends the character \a c. */
+				void append(char c);
+				/*! Appends the Latin-1 bytes of \a str. */
+				void append(const QString& str);
+				/*! Appends the decimal representation of \a number. */
+				void appendNumber(int number);
+
+			private:
+				char* m_data;
+				int m_size;
+				int m_length;
+		};
+
 		/*!
 		 * Initializes the variant.
 		 *
@@ -360,12 +514,16 @@ class LIB_EXPORT Board
 		Square chessSquare(int index) const;
 		/*! Converts a string into a Square object. */
 		Square chessSquare(const QString& str) const;
+		/*! Converts a Latin-1 string of \a length bytes into a Square. */
+		Square chessSquare(const char* str, int length) const;
 		/*! Converts a Square object into a square index. */
 		int squareIndex(const Square& square) const;
 		/*! Converts a string into a square index. */
 		int squareIndex(const QString& str) const;
 		/*! Converts a square index into a string. */
 		QString squareString(int index) const;
+		/*! Appends the string of square \a index to \a buffer. */
+		void appendSquareString(FenBuffer& buffer, int index) const;
 		/*! Converts a Square object into a string. */
 		QString squareString(const Square& square) const;
 
@@ -385,6 +543,25 @@ class LIB_EXPORT Board
 		virtual Move moveFromLanString(const QString& str);
 		/*! Converts a string in SAN format into a Move object. */
 		virtual Move moveFromSanString(const QString& str) = 0;
+		/*!
+		 * Converts a Latin-1 string of \a length bytes in LAN format
+		 * into a Move object.
+		 *
+		 * The default implementation is the byte-oriented parser
+		 * used by moveFromLanString().
+		 */
+		virtual Move moveFromLanBytes(const char* str, int length);
+		/*!
+		 * Converts a Latin-1 string of \a length bytes in SAN format
+		 * into a Move object.
+		 *
+		 * The default implementation calls moveFromSanString().
+		 */
+		virtual Move moveFromSanBytes(const char* str, int length);
+		/*! A stack buffer for the Latin-1 bytes of a move string. */
+		typedef QVarLengthArray<char, 32> MoveBytes;
+		/*! Stores the Latin-1 bytes of \a str in \a bytes. */
+		static void toMoveBytes(const QString& str, MoveBytes& bytes);
 		/*! Returns the maximal length of a piece symbol */
 		virtual int maxPieceSymbolLength() const;
 
@@ -396,6 +573,17 @@ class LIB_EXPORT Board
 		 * returns the rest of it, if any.
 		 */
 		virtual QString vFenString(FenNotation notation) const = 0;
+
+		/*!
+		 * Writes the latter part of the current position's FEN
+		 * string to \a buffer.
+		 *
+		 * This is the allocation-free counterpart of vFenString(),
+		 * used by fenString(char*, int, FenNotation). The default
+		 * implementation appends the output of vFenString().
+		 */
+		virtual void vFenBytes(FenBuffer& buffer,
+				       FenNotation notation) const;
 		/*!
 		 * Sets the board according to a FEN string.
 		 *
@@ -412,16 +600,20 @@ class LIB_EXPORT Board
 		 * for every piece type.
 		 * \sa legalMoves()
 		 */
-		void generateMoves(QVarLengthArray<Move>& moves,
+		void generateMoves(MoveList& moves,
 				   int pieceType = Piece::NoPiece) const;
 		/*!
 		 * Generates piece drops for pieces of type \a pieceType.
 		 *
 		 * \note If \a pieceType is Piece::NoPiece, moves are generated
 		 * for every piece type.
+		 *
+		 * The default implementation calls generateMovesForPiece()
+		 * with a zero square for each piece type in the reserve.
 		 * \sa generateMoves()
 		 */
-		void generateDropMoves(QVarLengthArray<Move>& moves, int pieceType) const;
+		virtual void generateDropMoves(MoveList& moves,
+					       int pieceType) const;
 		/*!
 		 * Generates pseudo-legal moves for a piece of \a pieceType
 		 * at square \a square.
@@ -429,7 +621,7 @@ class LIB_EXPORT Board
 		 * \note It doesn't matter if \a square doesn't contain a piece of
 		 * \a pieceType, the move generator ignores it.
 		 */
-		virtual void generateMovesForPiece(QVarLengthArray<Move>& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const = 0;
 		/*!
@@ -440,8 +632,8 @@ class LIB_EXPORT Board
 		 * \note The generated moves include captures
 		 */
 		void generateHoppingMoves(int sourceSquare,
-					  const QVarLengthArray<int>& offsets,
-					  QVarLengthArray<Move>& moves) const;
+					  const QVector<int>& offsets,
+					  MoveList& moves) const;
 		/*!
 		 * Generates sliding moves for a piece.
 		 *
@@ -450,8 +642,8 @@ class LIB_EXPORT Board
 		 * \note The generated moves include captures
 		 */
 		void generateSlidingMoves(int sourceSquare,
-					  const QVarLengthArray<int>& offsets,
-					  QVarLengthArray<Move>& moves) const;
+					  const QVector<int>& offsets,
+					  MoveList& moves) const;
 		/*!
 		 * Returns true if the current position is a legal position.
 		 * If the position isn't legal it usually means that the last
@@ -498,8 +690,22 @@ class LIB_EXPORT Board
 		 * subclasses shouldn't mess with it directly.
 		 */
 		void setSquare(int square, Piece piece);
+		/*!
+		 * Returns the squares occupied by pieces of \a side,
+		 * in no particular order.
+		 */
+		const QVarLengthArray<int, 32>& pieceSquares(Side side) const;
 		/*! Returns the last move made in the game. */
 		const Move& lastMove() const;
+		/*!
+		 * Returns the undo record of the last move.
+		 *
+		 * In vMakeMove() this is the record of the move being made,
+		 * and in vUndoMove() the record of the move being undone.
+		 */
+		MoveState& moveState();
+		/*! \overload */
+		const MoveState& moveState() const;
 		/*!
 		 * Returns the reserve piece type corresponding to \a pieceType.
 		 *
@@ -515,7 +721,39 @@ class LIB_EXPORT Board
 		/*! Removes a piece of type \a piece from the reserve. */
 		void removeFromReserve(const Piece& piece);
 
+		/*!
+		 * Keeps the position in bitboards in addition to the square
+		 * array, which allows subclasses to generate moves and detect
+		 * attacks with bitboards.
+		 *
+		 * Only 8x8 boards with less than 16 piece types can have
+		 * bitboards. This function should be called in vInitialize().
+		 * Returns true if successful; otherwise returns false.
+		 * \sa hasBitboards()
+		 */
+		bool enableBitboards();
+		/*! Returns true if the position is also kept in bitboards. */
+		bool hasBitboards() const;
+		/*! Returns the squares occupied by any piece. */
+		Bitboard occupiedBitboard() const;
+		/*! Returns the squares occupied by pieces of \a side. */
+		Bitboard sideBitboard(Side side) const;
+		/*! Returns the squares occupied by pieces of \a side and \a pieceType. */
+		Bitboard pieceBitboard(Side side, int pieceType) const;
+		/*!
+		 * Returns the squares occupied by pieces of \a side that can
+		 * move like \a movement.
+		 */
+		Bitboard movementBitboard(Side side, unsigned movement) const;
+
 	private:
+		// Board sizes that have compile-time square arithmetic
+		enum Geometry
+		{
+			AnyGeometry,
+			Board8x8,
+			Board10x8
+		};
 		struct PieceData
 		{
 			QString name;
@@ -523,16 +761,28 @@ class LIB_EXPORT Board
 			unsigned movement;
 			QString representation;
 		};
-		struct MoveData
+		// Number of plies the undo stack holds without allocating
+		static const int UndoStackSize = 256;
+		// Number of position key counters used to quickly rule
+		// out repetitions. Must be a power of two.
+		static const int RepetitionFilterSize = 1024;
+		static const int BitboardPieceTypes = 16;
+		struct Bitboards
 		{
-			Move move;
-			quint64 key;
+			Bitboard side[2];
+			Bitboard type[BitboardPieceTypes];
 		};
 		friend LIB_EXPORT QDebug operator<<(QDebug dbg, const Board* board);
 
+		void clearPosition();
+		bool finishPosition(Side side, const QStringList& fen);
+		bool hasLegalMoveCache() const;
+		void appendPieceSymbol(FenBuffer& buffer, Piece piece) const;
+
 		bool m_initialized;
 		int m_width;
 		int m_height;
+		Geometry m_geometry;
 		Side m_side;
 		Side m_startingSide;
 		QString m_startingFen;
@@ -540,10 +790,19 @@ class LIB_EXPORT Board
 		quint64 m_key;
 		Zobrist* m_zobrist;
 		QSharedPointer<Zobrist> m_sharedZobrist;
-		QVarLengthArray<PieceData> m_pieceData;
+		QVector<PieceData> m_pieceData;
 		QVarLengthArray<Piece> m_squares;
-		QVector<MoveData> m_moveHistory;
+		QVarLengthArray<int, 32> m_pieceSquares[2];
+		QVarLengthArray<int> m_pieceIndex;
+		QVarLengthArray<int, 16> m_pieceCount[2];
+		QVarLengthArray<MoveState, UndoStackSize> m_moveHistory;
+		quint64 m_legalMoveKey;
+		int m_legalMovePly;
+		MoveList m_legalMoveCache;
+		int m_repetitionFilter[RepetitionFilterSize];
 		QVector<int> m_reserve[2];
+		bool m_hasBitboards;
+		Bitboards m_bitboards;
 };
 
 
@@ -592,9 +851,60 @@ inline void Board::setSquare(int square, Piece piece)
 	if (piece.isValid())
 		xorKey(m_zobrist->piece(piece, square));
 
+	// Keep the piece lists and counts up to date. A removed piece
+	// is replaced by the last piece on the list.
+	if (old.isValid())
+	{
+		QVarLengthArray<int, 32>& list = m_pieceSquares[old.side()];
+		int index = m_pieceIndex[square];
+		int last = list.last();
+		list[index] = last;
+		m_pieceIndex[last] = index;
+		list.removeLast();
+		m_pieceCount[old.side()][old.type()]--;
+	}
+	if (piece.isValid())
+	{
+		QVarLengthArray<int, 32>& list = m_pieceSquares[piece.side()];
+		m_pieceIndex[square] = list.size();
+		list.append(square);
+		m_pieceCount[piece.side()][piece.type()]++;
+	}
+
+	if (m_hasBitboards)
+	{
+		Bitboard bit = BitboardAttacks::squareBit(
+			BitboardAttacks::fromIndex(square));
+		if (old.isValid())
+		{
+			m_bitboards.side[old.side()] ^= bit;
+			m_bitboards.type[old.type()] ^= bit;
+		}
+		if (piece.isValid())
+		{
+			Q_ASSERT(piece.type() < BitboardPieceTypes);
+			m_bitboards.side[piece.side()] ^= bit;
+			m_bitboards.type[piece.type()] ^= bit;
+		}
+	}
+
 	old = piece;
 }
 
+inline int Board::pieceCount(Side side, int pieceType) const
+{
+	Q_ASSERT(!side.isNull());
+	if (pieceType == Piece::NoPiece)
+		return m_pieceSquares[side].size();
+	return m_pieceCount[side][pieceType];
+}
+
+inline const QVarLengthArray<int, 32>& Board::pieceSquares(Side side) const
+{
+	Q_ASSERT(!side.isNull());
+	return m_pieceSquares[side];
+}
+
 inline int Board::plyCount() const
 {
 	return m_moveHistory.size();
@@ -605,6 +915,37 @@ inline const Move& Board::lastMove() const
 	return m_moveHistory.last().move;
 }
 
+inline MoveState& Board::moveState()
+{
+	return m_moveHistory.last();
+}
+
+inline const MoveState& Board::moveState() const
+{
+	return m_moveHistory.last();
+}
+
+inline bool Board::hasBitboards() const
+{
+	return m_hasBitboards;
+}
+
+inline Bitboard Board::occupiedBitboard() const
+{
+	return m_bitboards.side[Side::White] | m_bitboards.side[Side::Black];
+}
+
+inline Bitboard Board::sideBitboard(Side side) const
+{
+	return m_bitboards.side[side];
+}
+
+inline Bitboard Board::pieceBitboard(Side side, int pieceType) const
+{
+	Q_ASSERT(pieceType < BitboardPieceTypes);
+	return m_bitboards.side[side] & m_bitboards.type[pieceType];
+}
+
 inline bool Board::pieceHasMovement(int pieceType, unsigned movement) const
 {
 	Q_ASSERT(pieceType != Piece::NoPiece);
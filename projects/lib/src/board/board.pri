@@ -1,5 +1,6 @@
 DEPENDPATH += $$PWD
 SOURCES += $$PWD/board.cpp \
+    $$PWD/bitboard.cpp \
     $$PWD/westernboard.cpp \
     $$PWD/square.cpp \
     $$PWD/standardboard.cpp \
@@ -47,7 +48,10 @@ SOURCES += $$PWD/board.cpp \
     $$PWD/boardtransition.cpp \
     $$PWD/syzygytablebase.cpp
 HEADERS += $$PWD/board.h \
+    $$PWD/bitboard.h \
+    $$PWD/boardgeometry.h \
     $$PWD/move.h \
+    $$PWD/movestate.h \
     $$PWD/piece.h \
     $$PWD/westernboard.h \
     $$PWD/square.h \
@@ -16,6 +16,9 @@
 */
 
 #include "boardfactory.h"
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
 #include "andernachboard.h"
 #include "antiboard.h"
 #include "atomicboard.h"
@@ -110,7 +113,25 @@ ClassRegistry<Board>* BoardFactory::registry()
 
 Board* BoardFactory::create(const QString& variant)
 {
-	return registry()->create(variant);
+	// Every variant has an initialized prototype board. New boards
+	// are copies of it, so they share the piece definitions, move
+	// offsets and zobrist keys instead of building them again.
+	static QMap<QString, Board*> prototypes;
+	static QMutex mutex;
+	QMutexLocker locker(&mutex);
+
+	Board* prototype = prototypes.value(variant);
+	if (prototype == nullptr)
+	{
+		prototype = registry()->create(variant);
+		if (prototype == nullptr)
+			return nullptr;
+
+		prototype->initialize();
+		prototypes[variant] = prototype;
+	}
+
+	return prototype->copy();
 }
 
 QStringList BoardFactory::variants()
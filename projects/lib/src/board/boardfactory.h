@@ -34,6 +34,10 @@ class LIB_EXPORT BoardFactory
 		/*!
 		 * Creates and returns a new Board of variant \a variant.
 		 * Returns 0 if \a variant is not supported.
+		 *
+		 * The board is already initialized, and its immutable
+		 * variant data is shared with the other boards of the
+		 * same variant.
 		 */
 		static Board* create(const QString& variant);
 		/*! Returns a list of supported chess variants. */
@@ -0,0 +1,74 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BOARDGEOMETRY_H
+#define BOARDGEOMETRY_H
+
+namespace Chess {
+
+/*!
+ * \brief Square arithmetic for a board of a fixed size
+ *
+ * The functions convert between files and ranks and the indexes of
+ * Board's internal square array, which has a wall of one file on both
+ * sides of the board and two ranks above and below it. Because the
+ * dimensions are template parameters, the arithmetic compiles down to
+ * constants and multiplications instead of divisions by a runtime
+ * array width.
+ *
+ * Board uses this class for the common board sizes and falls back to
+ * runtime arithmetic for the others.
+ */
+template<int Width, int Height>
+class BoardGeometry
+{
+	public:
+		/*! The width of the square array, including the walls. */
+		static constexpr int ArrayWidth = Width + 2;
+		/*! The size of the square array, including the walls. */
+		static constexpr int ArraySize = ArrayWidth * (Height + 4);
+
+		/*! Returns true if \a file and \a rank are on the board. */
+		static constexpr bool isValidSquare(int file, int rank)
+		{
+			return file >= 0 && file < Width
+			    && rank >= 0 && rank < Height;
+		}
+		/*! Returns the array index of \a file and \a rank. */
+		static constexpr int squareIndex(int file, int rank)
+		{
+			return (Height + 1 - rank) * ArrayWidth + 1 + file;
+		}
+		/*! Returns the file of array index \a index. */
+		static constexpr int file(int index)
+		{
+			return index % ArrayWidth - 1;
+		}
+		/*! Returns the rank of array index \a index. */
+		static constexpr int rank(int index)
+		{
+			return Height + 1 - index / ArrayWidth;
+		}
+};
+
+/*! Geometry of 8x8 boards, eg. standard chess. */
+typedef BoardGeometry<8, 8> Geometry8x8;
+/*! Geometry of 10x8 boards, eg. Capablanca chess. */
+typedef BoardGeometry<10, 8> Geometry10x8;
+
+} // namespace Chess
+#endif // BOARDGEOMETRY_H
@@ -49,7 +49,7 @@ QString CapablancaBoard::defaultFenString() const
 
 void CapablancaBoard::addPromotions(int sourceSquare,
 				int targetSquare,
-				QVarLengthArray<Move>& moves) const
+				MoveList& moves) const
 {
 	WesternBoard::addPromotions(sourceSquare, targetSquare, moves);
 
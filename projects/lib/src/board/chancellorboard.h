@@ -62,7 +62,7 @@ class LIB_EXPORT ChancellorBoard : public WesternBoard
 		virtual int castlingFile(CastlingSide castlingSide) const;
 		virtual void addPromotions(int sourceSquare,
 					   int targetSquare,
-					   QVarLengthArray< Move >& moves) const;
+					   MoveList& moves) const;
 };
 
 } // namespace Chess
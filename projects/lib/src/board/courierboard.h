@@ -81,12 +81,12 @@ class LIB_EXPORT CourierBoard : public ShatranjBoard
 		// Inherited from ShatranjBoard
 		virtual void vInitialize();
 		virtual bool inCheck(Side side, int square = 0) const;
-		virtual void generateMovesForPiece(QVarLengthArray<Move>& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
 	private:
 		int m_arwidth;
-		QVarLengthArray<int> m_wazirOffsets;
+		QVector<int> m_wazirOffsets;
 };
 
 } // namespace Chess
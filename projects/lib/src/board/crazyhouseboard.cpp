@@ -63,6 +63,16 @@ QString CrazyhouseBoard::defaultFenString() const
 	return "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR[-] w KQkq - 0 1";
 }
 
+bool CrazyhouseBoard::useBitboards() const
+{
+	return true;
+}
+
+bool CrazyhouseBoard::hasStandardLegality() const
+{
+	return true;
+}
+
 int CrazyhouseBoard::reserveType(int pieceType) const
 {
 	if (pieceType >= PromotedKnight && pieceType <= PromotedQueen)
@@ -147,6 +157,11 @@ QString CrazyhouseBoard::sanMoveString(const Move& move)
 	return str;
 }
 
+bool CrazyhouseBoard::hasStandardMoveNotation() const
+{
+	return false;
+}
+
 Move CrazyhouseBoard::moveFromSanString(const QString& str)
 {
 	if (str.isEmpty())
@@ -216,7 +231,56 @@ bool CrazyhouseBoard::pawnDropOkOnRank(int rank) const
 	return rank > 0 && rank < height() - 1;
 }
 
-void CrazyhouseBoard::generateMovesForPiece(QVarLengthArray<Move>& moves,
+void CrazyhouseBoard::generateDropMoves(MoveList& moves, int pieceType) const
+{
+	if (!hasBitboards())
+	{
+		WesternBoard::generateDropMoves(moves, pieceType);
+		return;
+	}
+
+	Side side = sideToMove();
+	int first = (pieceType == Piece::NoPiece) ? int(Pawn) : pieceType;
+	int last = (pieceType == Piece::NoPiece) ? int(PromotedQueen) : pieceType;
+	bool hasReserve = false;
+	for (int type = first; type <= last && !hasReserve; type++)
+		hasReserve = reserveCount(Piece(side, type)) > 0;
+	if (!hasReserve)
+		return;
+
+	const Bitboard targets = dropTargets();
+	if (!targets)
+		return;
+
+	for (int type = first; type <= last; type++)
+	{
+		if (reserveCount(Piece(side, type)) <= 0)
+			continue;
+
+		Bitboard bb = targets;
+		if (type == Pawn)
+		{
+			Bitboard mask = 0;
+			for (int rank = 0; rank < height(); rank++)
+			{
+				if (!pawnDropOkOnRank(rank))
+					continue;
+				int sq = BitboardAttacks::fromIndex(
+					squareIndex(Square(0, rank)));
+				mask |= Bitboard(0xff) << sq;
+			}
+			bb &= mask;
+		}
+
+		while (bb)
+		{
+			int target = BitboardAttacks::toIndex(BitboardAttacks::popLsb(bb));
+			moves.append(Move(0, target, type));
+		}
+	}
+}
+
+void CrazyhouseBoard::generateMovesForPiece(MoveList& moves,
 					    int pieceType,
 					    int square) const
 {
@@ -69,15 +69,20 @@ class LIB_EXPORT CrazyhouseBoard : public WesternBoard
 		virtual bool pawnDropOkOnRank(int rank) const;
 
 		// Inherited from WesternBoard
+		virtual bool useBitboards() const;
+		virtual bool hasStandardLegality() const;
 		virtual int reserveType(int pieceType) const;
 		virtual QString sanMoveString(const Move& move);
+		virtual bool hasStandardMoveNotation() const;
 		virtual Move moveFromSanString(const QString& str);
 		virtual void vMakeMove(const Move& move,
 				       BoardTransition* transition);
 		virtual void vUndoMove(const Move& move);
-		virtual void generateMovesForPiece(QVarLengthArray<Move>& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
+		virtual void generateDropMoves(MoveList& moves,
+					       int pieceType) const;
 
 	private:
 		static int normalPieceType(int type);
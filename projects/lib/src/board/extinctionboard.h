@@ -63,9 +63,10 @@ class LIB_EXPORT ExtinctionBoard : public StandardBoard
 		virtual bool kingsCountAssertion(int whiteKings,
 						 int blackKings) const;
 		virtual bool inCheck(Side side, int square = 0) const;
+		virtual bool hasStandardLegality() const;
 		virtual void addPromotions(int sourceSquare,
 					   int targetSquare,
-					   QVarLengthArray<Move>& moves) const;
+					   MoveList& moves) const;
 
 	private:
 		bool m_allPromotions;
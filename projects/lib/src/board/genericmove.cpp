@@ -17,6 +17,46 @@
 
 #include "genericmove.h"
 
+namespace {
+
+/*
+ * Compact move layouts:
+ *
+ * Up to 64 squares:
+ *	bits 0-5	target square
+ *	bits 6-11	source square, same as the target for drops
+ *	bits 12-15	promotion type - 1, or the type of a dropped piece
+ *
+ * Up to 128 squares, the tag in bits 14-15 selects:
+ *	00: bits 0-6 target square, bits 7-13 source square
+ *	10: pawn promotion; bits 0-6 target square, bits 7-10
+ *	    promotion type, bits 11-12 file step + 1, bit 13 set if
+ *	    the pawn moves towards rank 0
+ *	11: drop; bits 0-6 target square, bits 7-13 piece type
+ *
+ * A value of 0 is a null move in both layouts.
+ */
+const int SmallBoardSquares = 64;
+const int LargeBoardSquares = 128;
+const int PromotionTag = 0x8000;
+const int DropTag = 0xc000;
+
+int compactSquare(const Chess::Square& square, int width, int height)
+{
+	if (!square.isValid()
+	||  square.file() >= width
+	||  square.rank() >= height)
+		return -1;
+	return square.rank() * width + square.file();
+}
+
+Chess::Square chessSquare(int index, int width)
+{
+	return Chess::Square(index % width, index / width);
+}
+
+} // anonymous namespace
+
 namespace Chess {
 
 GenericMove::GenericMove()
@@ -87,4 +127,105 @@ void GenericMove::setPromotion(int pieceType)
 	m_promotion = pieceType;
 }
 
+quint16 GenericMove::toCompact(int width, int height) const
+{
+	int squares = width * height;
+	if (isNull() || squares > LargeBoardSquares)
+		return 0;
+
+	int target = compactSquare(m_targetSquare, width, height);
+	if (target == -1)
+		return 0;
+
+	// Drop
+	if (!m_sourceSquare.isValid())
+	{
+		if (squares <= SmallBoardSquares)
+		{
+			if (m_promotion > 15)
+				return 0;
+			return target | (target << 6) | (m_promotion << 12);
+		}
+		if (m_promotion > 127)
+			return 0;
+		return DropTag | (m_promotion << 7) | target;
+	}
+
+	int source = compactSquare(m_sourceSquare, width, height);
+	if (source == -1 || source == target)
+		return 0;
+
+	if (squares <= SmallBoardSquares)
+	{
+		// Nothing promotes to a pawn, so the promotion
+		// field can hold piece types up to 16
+		if (m_promotion == 1 || m_promotion > 16)
+			return 0;
+		int promotion = m_promotion ? m_promotion - 1 : 0;
+		return target | (source << 6) | (promotion << 12);
+	}
+
+	if (!m_promotion)
+		return (source << 7) | target;
+
+	int fileStep = m_targetSquare.file() - m_sourceSquare.file();
+	int rankStep = m_targetSquare.rank() - m_sourceSquare.rank();
+	if (m_promotion > 15
+	||  qAbs(fileStep) > 1
+	||  qAbs(rankStep) != 1)
+		return 0;
+
+	return PromotionTag
+	     | (rankStep < 0 ? 0x2000 : 0)
+	     | ((fileStep + 1) << 11)
+	     | (m_promotion << 7)
+	     | target;
+}
+
+GenericMove GenericMove::fromCompact(quint16 move, int width, int height)
+{
+	int squares = width * height;
+	if (move == 0 || squares > LargeBoardSquares)
+		return GenericMove();
+
+	if (squares <= SmallBoardSquares)
+	{
+		int target = move & 0x3f;
+		int source = (move >> 6) & 0x3f;
+		int type = move >> 12;
+		if (target >= squares || source >= squares)
+			return GenericMove();
+
+		if (source == target)
+			return GenericMove(Square(), chessSquare(target, width), type);
+		return GenericMove(chessSquare(source, width),
+				   chessSquare(target, width),
+				   type ? type + 1 : 0);
+	}
+
+	int target = move & 0x7f;
+	if (target >= squares)
+		return GenericMove();
+	Square targetSquare(chessSquare(target, width));
+
+	if ((move & DropTag) == DropTag)
+		return GenericMove(Square(), targetSquare, (move >> 7) & 0x7f);
+
+	if (move & PromotionTag)
+	{
+		int fileStep = ((move >> 11) & 3) - 1;
+		int rankStep = (move & 0x2000) ? -1 : 1;
+		Square sourceSquare(targetSquare.file() - fileStep,
+				    targetSquare.rank() - rankStep);
+		if (compactSquare(sourceSquare, width, height) == -1)
+			return GenericMove();
+		return GenericMove(sourceSquare, targetSquare, (move >> 7) & 0xf);
+	}
+
+	int source = (move >> 7) & 0x7f;
+	if (source >= squares)
+		return GenericMove();
+	return GenericMove(chessSquare(source, width), targetSquare, 0);
+}
+
 } // namespace Chess
@@ -62,6 +62,29 @@ class LIB_EXPORT GenericMove
 		/*! Sets the promotion type to \a pieceType. */
 		void setPromotion(int pieceType);
 
+		/*!
+		 * Encodes the move in 16 bits for a board of \a width
+		 * by \a height squares.
+		 *
+		 * Boards of up to 64 squares store the source and target
+		 * squares in 6 bits each and the promotion or drop type in
+		 * 4 bits. Boards of up to 128 squares use 7-bit squares;
+		 * their promotions must be pawn steps to an adjacent rank
+		 * and file, as they are in all supported variants.
+		 *
+		 * Returns 0 for a null move or a move that can't be
+		 * encoded, eg. on a board with more than 128 squares.
+		 * \sa fromCompact()
+		 */
+		quint16 toCompact(int width, int height) const;
+		/*!
+		 * Decodes a move encoded by toCompact() for a board of
+		 * \a width by \a height squares.
+		 *
+		 * Returns a null move if \a move is 0 or invalid.
+		 */
+		static GenericMove fromCompact(quint16 move, int width, int height);
+
 	private:
 		Square m_sourceSquare;
 		Square m_targetSquare;
@@ -137,7 +137,7 @@ bool GryphonBoard::isLegalPosition()
 	return true;
 }
 
-void GryphonBoard::generateMovesForPiece(QVarLengthArray< Move >& moves,
+void GryphonBoard::generateMovesForPiece(MoveList& moves,
 					 int pieceType,
 					 int square) const
 {
@@ -179,14 +179,14 @@ QString SimplifiedGryphonBoard::defaultFenString() const
 	return "4k3/pppppppp/8/8/8/8/PPPPPPPP/4K3 w - - 0 1";
 }
 
-void SimplifiedGryphonBoard::generateMovesForPiece(QVarLengthArray< Move >& moves,
+void SimplifiedGryphonBoard::generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const
 {
 	if (pieceType != King)
 		return GryphonBoard::generateMovesForPiece(moves, pieceType, square);
 
-	QVarLengthArray< Move > newmoves;
+	MoveList newmoves;
 	GryphonBoard::generateMovesForPiece(newmoves, King, square);
 
 	for (const Move move: newmoves)
@@ -299,7 +299,7 @@ int ChangeOverBoard::successorType(int type, bool reversed) const
 /*
  * This variant does not have the restriction to two sets of regular pieces.
  */
-void ChangeOverBoard::generateMovesForPiece(QVarLengthArray< Move >& moves,
+void ChangeOverBoard::generateMovesForPiece(MoveList& moves,
 					    int pieceType,
 					    int square) const
 {
@@ -63,7 +63,7 @@ class LIB_EXPORT GryphonBoard : public WesternBoard
 				       BoardTransition* transition);
 		virtual void vUndoMove(const Move& move);
 		virtual bool isLegalPosition();
-		virtual void generateMovesForPiece(QVarLengthArray< Move >& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
 
@@ -111,7 +111,7 @@ class LIB_EXPORT SimplifiedGryphonBoard : public GryphonBoard
 		virtual QString defaultFenString() const;
 
 	protected:
-		virtual void generateMovesForPiece(QVarLengthArray< Move >& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
 		virtual void vMakeMove(const Move& move,
@@ -197,7 +197,7 @@ class LIB_EXPORT ChangeOverBoard : public CircularGryphonBoard
 	protected:
 		virtual int successorType(int type,
 					  bool reversed = false) const;
-		virtual void generateMovesForPiece(QVarLengthArray< Move >& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
 		virtual bool isLegalPosition();
@@ -48,7 +48,7 @@ QString JanusBoard::defaultFenString() const
 
 void JanusBoard::addPromotions(int sourceSquare,
 				int targetSquare,
-				QVarLengthArray<Move>& moves) const
+				MoveList& moves) const
 {
 	WesternBoard::addPromotions(sourceSquare, targetSquare, moves);
 	moves.append(Move(sourceSquare, targetSquare, Janus));
@@ -75,6 +75,11 @@ QString JanusBoard::sanMoveString(const Move& move)
 }
 
 
+bool JanusBoard::hasStandardMoveNotation() const
+{
+	return false;
+}
+
 Move JanusBoard::moveFromSanString(const QString& str)
 {
 	/*
@@ -44,7 +44,7 @@ QString KnightMateBoard::defaultFenString() const
 
 void KnightMateBoard::addPromotions(int sourceSquare,
 				    int targetSquare,
-				    QVarLengthArray< Move >& moves) const
+				    MoveList& moves) const
 {
 	moves.append(Move(sourceSquare, targetSquare, Mann));
 	moves.append(Move(sourceSquare, targetSquare, Bishop));
@@ -52,13 +52,13 @@ void KnightMateBoard::addPromotions(int sourceSquare,
 	moves.append(Move(sourceSquare, targetSquare, Queen));
 }
 
-void KnightMateBoard::generateMovesForPiece(QVarLengthArray<Move>& moves,
+void KnightMateBoard::generateMovesForPiece(MoveList& moves,
 					    int pieceType,
 					    int square) const
 {
 	if (pieceType == King || pieceType == Mann)
 	{
-		QVarLengthArray <Move> testmoves;
+		MoveList testmoves;
 		WesternBoard::generateMovesForPiece(testmoves, King, square);
 		for (const auto m: testmoves)
 		{
@@ -83,7 +83,7 @@ bool KnightMateBoard::inCheck(Side side, int square) const
 	if (square == 0)
 		square = kingSquare(side);
 
-	QVarLengthArray <Move> moves;
+	MoveList moves;
 	if (sideToMove() == side)
 		// needs symmetry of piece movement of both sides
 		for (int type = Pawn; type <= Mann; type++)
@@ -108,6 +108,11 @@ bool KnightMateBoard::inCheck(Side side, int square) const
 	return false;
 }
 
+bool KnightMateBoard::hasStandardMoveNotation() const
+{
+	return false;
+}
+
 Move KnightMateBoard::moveFromSanString(const QString& str)
 {
 	QString kingSymbol(pieceSymbol(King).toUpper());
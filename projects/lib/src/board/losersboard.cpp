@@ -58,7 +58,7 @@ bool LosersBoard::vIsLegalMove(const Move& move)
 		m_captureKey = key();
 		m_canCapture = false;
 
-		QVarLengthArray<Move> moves;
+		MoveList moves;
 		generateMoves(moves);
 
 		for (int i = 0; i < moves.size(); i++)
@@ -60,7 +60,7 @@ int ModernBoard::castlingFile(WesternBoard::CastlingSide castlingSide) const
 	return castlingSide == QueenSide ? 2 : 6; // c-file and g-file
 }
 
-void ModernBoard::addPromotions(int sourceSquare, int targetSquare, QVarLengthArray< Move >& moves) const
+void ModernBoard::addPromotions(int sourceSquare, int targetSquare, MoveList& moves) const
 {
 	WesternBoard::addPromotions(sourceSquare, targetSquare, moves);
 	moves.append(Move(sourceSquare, targetSquare, Minister));
@@ -85,6 +85,11 @@ QString ModernBoard::sanMoveString(const Move& move)
 }
 
 // This method accepts Modern Chess notation for castling and also standard chess notation. 
+bool ModernBoard::hasStandardMoveNotation() const
+{
+	return false;
+}
+
 Move ModernBoard::moveFromSanString(const QString& str)
 {
 	bool isWhite = (sideToMove() == Side::White);
@@ -62,10 +62,11 @@ class LIB_EXPORT ModernBoard : public WesternBoard
 			Minister = 7 //!< Minister = Archbishop (knight + bishop)
 		};
 		// Inherited from WesternBoard
+		virtual bool hasStandardMoveNotation() const;
 		virtual int castlingFile(CastlingSide castlingSide) const;
 		virtual void addPromotions(int sourceSquare,
 					   int targetSquare,
-					   QVarLengthArray< Move >& moves) const;
+					   MoveList& moves) const;
 };
 
 } // namespace Chess
@@ -20,6 +20,7 @@
 
 #include <QtGlobal>
 #include <QMetaType>
+#include <QVarLengthArray>
 
 namespace Chess {
 
@@ -128,8 +129,18 @@ inline int Move::promotion() const
 	return (m_data >> 20) & 0x3FF;
 }
 
+/*!
+ * \brief A list of moves that is stored on the stack.
+ *
+ * The capacity is large enough for all the pseudo-legal moves of
+ * any supported variant, including piece drops, so generating moves
+ * doesn't allocate memory. Larger lists fall back to the heap.
+ */
+typedef QVarLengthArray<Move, 1024> MoveList;
+
 } // namespace Chess
 
+Q_DECLARE_TYPEINFO(Chess::Move, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(Chess::Move)
 
 #endif // MOVE_H
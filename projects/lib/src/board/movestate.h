@@ -0,0 +1,62 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MOVESTATE_H
+#define MOVESTATE_H
+
+#include <QtGlobal>
+#include "move.h"
+#include "piece.h"
+
+namespace Chess {
+
+/*!
+ * \brief The reversible state of a position before a move.
+ *
+ * Board keeps one MoveState per ply in a contiguous undo stack.
+ * Board fills in the move and the position key; subclasses save
+ * the rest of their reversible state in Board::moveState() when a
+ * move is made and restore it from there when the move is undone.
+ */
+struct MoveState
+{
+	/*! The move. */
+	Move move;
+	/*! Zobrist key of the position before the move. */
+	quint64 key;
+	/*! The captured piece. */
+	Piece capture;
+	/*! The en-passant square. */
+	int enpassantSquare;
+	/*! Square of the pawn that can be captured en passant. */
+	int enpassantTarget;
+	/*!
+	 * Castling rook squares.
+	 * Usage: 'castlingRights[Side][CastlingSide]'
+	 */
+	int castlingRights[2][2];
+	/*! The castling side of a castling move. */
+	int castlingSide;
+	/*! The reversible move count. */
+	int reversibleMoveCount;
+};
+
+} // namespace Chess
+
+Q_DECLARE_TYPEINFO(Chess::MoveState, Q_MOVABLE_TYPE);
+
+#endif // MOVESTATE_H
@@ -95,7 +95,7 @@ void PocketKnightBoard::vUndoMove(const Move& move)
 		addToReserve(Piece(sideToMove(), prom));
 }
 
-void PocketKnightBoard::generateMovesForPiece(QVarLengthArray< Move >& moves, int pieceType, int square) const
+void PocketKnightBoard::generateMovesForPiece(MoveList& moves, int pieceType, int square) const
 {
 	// Generate drops
 	if (square == 0)
@@ -59,7 +59,7 @@ bool RacingKingsBoard::finished(Side side) const
 /*! Returns true if the king of \a side can reach the eighth rank */
 bool RacingKingsBoard::canFinish(Side side)
 {
-	QVarLengthArray<Move> moves;
+	MoveList moves;
 	WesternBoard::generateMovesForPiece(moves, King, kingSquare(side));
 	for (const Move& m: moves)
 	{
@@ -41,7 +41,7 @@ bool RestrictedMoveBoard::inCheck(Side side, int square) const
 	if (square == 0)
 		square = kingSquare(side);
 
-	QVarLengthArray <Move> moves;
+	MoveList moves;
 	if (sideToMove() == side)
 		// needs symmetry of piece movement of both sides
 		for (int type = Pawn; type <= King; type++)
@@ -84,7 +84,7 @@ QList<Piece> SeirawanBoard::reservePieceTypes() const
 
 void SeirawanBoard::addPromotions(int sourceSquare,
 				  int targetSquare,
-				  QVarLengthArray<Move>& moves) const
+				  MoveList& moves) const
 {
 	WesternBoard::addPromotions(sourceSquare, targetSquare, moves);
 
@@ -138,6 +138,13 @@ bool SeirawanBoard::parseCastlingRights(QChar c)
 	return WesternBoard::parseCastlingRights(c);
 }
 
+void SeirawanBoard::vFenBytes(FenBuffer& buffer,
+			      FenNotation notation) const
+{
+	// The gating files are prepended to the castling field
+	Board::vFenBytes(buffer, notation);
+}
+
 QString SeirawanBoard::vFenString(Board::FenNotation notation) const
 {
 	QString vfs = Chess::WesternBoard::vFenString(notation);
@@ -277,6 +284,11 @@ QString SeirawanBoard::sanMoveString(const Move& move)
  * Castling moves with channeling onto rook squares use auxiliary promotion
  * piece types to differ from drops onto king squares.
  */
+bool SeirawanBoard::hasStandardMoveNotation() const
+{
+	return false;
+}
+
 Move SeirawanBoard::moveFromSanString(const QString& str)
 {
 	// leave orthodox moves to WesternBoard
@@ -386,14 +398,14 @@ void SeirawanBoard::vUndoMove(const Move& move)
 	WesternBoard::vUndoMove(move);
 }
 
-void SeirawanBoard::generateMovesForPiece(QVarLengthArray< Move >& moves,
+void SeirawanBoard::generateMovesForPiece(MoveList& moves,
 					  int pieceType,
 					  int square) const
 {
 	if (!isValidSquare(chessSquare(square)))
 		return;
 
-	QVarLengthArray< Move > moves1, moves2;
+	MoveList moves1, moves2;
 	WesternBoard::generateMovesForPiece(moves1, pieceType, square);
 
 	// add normal moves
@@ -68,18 +68,21 @@ class LIB_EXPORT SeirawanBoard : public WesternBoard
 		virtual QList< Piece > reservePieceTypes() const;
 		virtual void addPromotions(int sourceSquare,
 					   int targetSquare,
-					   QVarLengthArray<Move>& moves) const;
+					   MoveList& moves) const;
 		virtual bool vSetFenString(const QStringList& fen);
 		virtual bool parseCastlingRights(QChar c);
 		virtual QString vFenString(FenNotation notation) const;
+		virtual void vFenBytes(FenBuffer& buffer,
+				       FenNotation notation) const;
 		virtual QString lanMoveString(const Move& move);
 		virtual QString sanMoveString(const Move& move);
+		virtual bool hasStandardMoveNotation() const;
 		virtual Move moveFromSanString(const QString& str);
 		virtual Move moveFromLanString(const QString& str);
 		virtual void vMakeMove(const Move& move,
 				       BoardTransition* transition);
 		virtual void vUndoMove(const Move& move);
-		virtual void generateMovesForPiece(QVarLengthArray<Move>& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
 	private:
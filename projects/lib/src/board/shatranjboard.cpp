@@ -73,12 +73,12 @@ void ShatranjBoard::vInitialize()
 
 void ShatranjBoard::addPromotions(int sourceSquare,
 				 int targetSquare,
-				 QVarLengthArray<Move>& moves) const
+				 MoveList& moves) const
 {
 	moves.append(Move(sourceSquare, targetSquare, Ferz));
 }
 
-void ShatranjBoard::generateMovesForPiece(QVarLengthArray< Move >& moves,
+void ShatranjBoard::generateMovesForPiece(MoveList& moves,
 					  int pieceType,
 					  int square) const
 {
@@ -189,7 +189,7 @@ bool ShatranjBoard::canBareOpponentKing()
 	if (!bareKing(side.opposite(), -1))
 		return false;
 
-	QVarLengthArray<Move>moves;
+	MoveListmoves;
 	generateMovesForPiece(moves, King, kingSquare(side));
 	for (const auto &m: moves)
 	{
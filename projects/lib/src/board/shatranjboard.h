@@ -83,12 +83,12 @@ class LIB_EXPORT ShatranjBoard : public WesternBoard
 		virtual bool pawnHasDoubleStep() const;
 		virtual void vInitialize();
 		virtual bool inCheck(Side side, int square = 0) const;
-		virtual void generateMovesForPiece(QVarLengthArray<Move>& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
 		virtual void addPromotions(int sourceSquare,
 					   int targetSquare,
-					   QVarLengthArray<Move>& moves) const;
+					   MoveList& moves) const;
 
 		/*!
 		 * Returns true if the side to move can bare the opponent king with this move
@@ -97,8 +97,8 @@ class LIB_EXPORT ShatranjBoard : public WesternBoard
 		virtual bool canBareOpponentKing();
 	private:
 		int m_arwidth;
-		QVarLengthArray<int> m_ferzOffsets;
-		QVarLengthArray<int> m_alfilOffsets;
+		QVector<int> m_ferzOffsets;
+		QVector<int> m_alfilOffsets;
 		int pieceCount(Side side) const;
 		bool bareKing(Side side, int count = 0) const;
 };
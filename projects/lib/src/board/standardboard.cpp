@@ -1071,19 +1071,36 @@ QString StandardBoard::defaultFenString() const
 	return "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 }
 
+bool StandardBoard::useBitboards() const
+{
+	return true;
+}
+
+bool StandardBoard::hasStandardLegality() const
+{
+	return true;
+}
+
 Result StandardBoard::tablebaseResult(unsigned int* dtz) const
 {
-	SyzygyTablebase::PieceList pieces;
+	return probeTablebase(false, dtz);
+}
 
-	for (int i = 0; i < arraySize(); i++)
+Result StandardBoard::tablebaseWdlResult() const
+{
+	return probeTablebase(true, nullptr);
+}
+
+Result StandardBoard::probeTablebase(bool wdlOnly, unsigned int* dtz) const
+{
+	if (pieceCount(Side::White) + pieceCount(Side::Black) > 7)
+		return Result();
+
+	SyzygyTablebase::PieceList pieces;
+	for (int i = 0; i < 2; i++)
 	{
-		Piece piece(pieceAt(i));
-		if (piece.isValid())
-		{
-			if (pieces.size() > 6)
-				return Result();
-			pieces.append(qMakePair(chessSquare(i), piece));
-		}
+		for (const int sq: pieceSquares(Side::Type(i)))
+			pieces.append(qMakePair(chessSquare(sq), pieceAt(sq)));
 	}
 
 	SyzygyTablebase::Castling castling = 0;
@@ -1096,6 +1113,14 @@ Result StandardBoard::tablebaseResult(unsigned int* dtz) const
 	if (hasCastlingRight(Chess::Side::Black, QueenSide))
 		castling |= SyzygyTablebase::BlackQueenSide;
 
+	if (wdlOnly)
+		return SyzygyTablebase::wdlResult(sideToMove(),
+						  chessSquare(enpassantSquare()),
+						  castling,
+						  reversibleMoveCount(),
+						  pieces,
+						  key());
+
 	return SyzygyTablebase::result(sideToMove(),
 					chessSquare(enpassantSquare()),
 					castling,
@@ -45,6 +45,15 @@ class LIB_EXPORT StandardBoard : public WesternBoard
 		virtual QString variant() const;
 		virtual QString defaultFenString() const;
 		virtual Result tablebaseResult(unsigned int* dtm = nullptr) const;
+		virtual Result tablebaseWdlResult() const;
+
+	protected:
+		// Inherited from WesternBoard
+		virtual bool useBitboards() const;
+		virtual bool hasStandardLegality() const;
+
+	private:
+		Result probeTablebase(bool wdlOnly, unsigned int* dtz) const;
 };
 
 } // namespace Chess
@@ -16,9 +16,18 @@
 */
 
 #include "syzygytablebase.h"
+#include <QAtomicInteger>
+#include <QCoreApplication>
 #include <QDir>
-#include <QMutex>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QReadWriteLock>
+#include <QRunnable>
 #include <QStringList>
+#include <QThreadPool>
+#include <QtAlgorithms>
 #include <tbprobe.h>
 #include "westernboard.h"
 
@@ -26,7 +35,30 @@ namespace {
 
 bool s_initialized = false, s_initOK = false, s_noRule50 = false;
 int s_pieces = INT_MAX;
-QMutex s_mutex;
+QStringList s_paths;
+QAtomicInt s_stopPreload(0);
+
+QAtomicInteger<quint64> s_probeCount(0);
+QAtomicInteger<quint64> s_cacheHitCount(0);
+QAtomicInteger<qint64> s_probeTime(0);
+
+// WDL probe results shared by all games, indexed by zobrist key
+const int s_maxCacheSize = 1 << 20;
+QReadWriteLock s_cacheLock;
+QHash<quint64, unsigned> s_wdlCache;
+
+struct MaterialCounters
+{
+	mutable QAtomicInteger<quint64> hits;
+	mutable QAtomicInteger<quint64> misses;
+	mutable QAtomicInteger<qint64> probeTime;
+};
+
+// Per-material probe statistics. The write lock is only needed the
+// first time a material class is probed; QMap nodes stay in place
+// when other classes are inserted.
+QReadWriteLock s_statsLock;
+QMap<quint32, MaterialCounters> s_materialStats;
 
 int tbSquare(const Chess::Square& square)
 {
@@ -35,6 +67,188 @@ int tbSquare(const Chess::Square& square)
 	return square.rank() * 8 + square.file();
 }
 
+struct TbPosition
+{
+	uint64_t white, black;
+	uint64_t kings, queens, rooks, bishops, knights, pawns;
+	unsigned ep;
+	bool wtm;
+
+	TbPosition(const Chess::Side& side,
+		   const Chess::Square& enpassantSq,
+		   const SyzygyTablebase::PieceList& pieces)
+		: white(0), black(0),
+		  kings(0), queens(0), rooks(0), bishops(0), knights(0), pawns(0),
+		  ep(tbSquare(enpassantSq) < 0? 0: tbSquare(enpassantSq)),
+		  wtm(side == Chess::Side::White)
+	{
+		typedef QPair<Chess::Square, Chess::Piece> PcSq;
+		for (const PcSq& item : pieces)
+		{
+			if (tbSquare(item.first) < 0)
+				continue;
+			unsigned sq = tbSquare(item.first);
+			uint64_t bit = ((uint64_t)1 << sq);
+			if (item.second.side() == Chess::Side::White)
+				white |= bit;
+			else
+				black |= bit;
+			switch (item.second.type())
+			{
+			case Chess::WesternBoard::Pawn:
+				pawns |= bit; break;
+			case Chess::WesternBoard::Knight:
+				knights |= bit; break;
+			case Chess::WesternBoard::Bishop:
+				bishops |= bit; break;
+			case Chess::WesternBoard::Rook:
+				rooks |= bit; break;
+			case Chess::WesternBoard::Queen:
+				queens |= bit; break;
+			case Chess::WesternBoard::King:
+				kings |= bit; break;
+			}
+		}
+	}
+};
+
+Chess::Side wdlWinner(unsigned wdl, bool wtm)
+{
+	switch (wdl)
+	{
+	case TB_BLESSED_LOSS:
+		if (!s_noRule50)
+			break;
+		// Fallthrough
+	case TB_LOSS:
+		return (wtm? Chess::Side::Black: Chess::Side::White);
+	case TB_CURSED_WIN:
+		if (!s_noRule50)
+			break;
+		// Fallthrough
+	case TB_WIN:
+		return (wtm? Chess::Side::White: Chess::Side::Black);
+	default:
+		break;
+	}
+
+	return Chess::Side::NoSide;
+}
+
+/*
+ * Packs the number of non-king pieces of each type and side into
+ * 3-bit fields: white Q, R, B, N, P followed by black Q, R, B, N, P.
+ */
+quint32 materialClass(const TbPosition& pos)
+{
+	const uint64_t types[] = {
+		pos.queens, pos.rooks, pos.bishops, pos.knights, pos.pawns
+	};
+	quint32 key = 0;
+	for (uint64_t side : { pos.white, pos.black })
+	{
+		for (uint64_t type : types)
+			key = (key << 3) | qMin(qPopulationCount(quint64(side & type)), 7u);
+	}
+
+	return key;
+}
+
+QString materialClassName(quint32 key)
+{
+	static const char symbols[] = "QRBNP";
+	QString name;
+	for (int side = 0; side < 2; side++)
+	{
+		if (side == 1)
+			name += QLatin1Char('v');
+		name += QLatin1Char('K');
+		for (int i = 0; i < 5; i++)
+		{
+			int shift = ((1 - side) * 5 + 4 - i) * 3;
+			int count = (key >> shift) & 7;
+			name += QString(count, QLatin1Char(symbols[i]));
+		}
+	}
+
+	return name;
+}
+
+void addProbe(const TbPosition& pos, const QElapsedTimer& timer, bool found)
+{
+	const qint64 nsecs = timer.nsecsElapsed();
+	s_probeCount.fetchAndAddRelaxed(1);
+	s_probeTime.fetchAndAddRelaxed(nsecs);
+
+	const quint32 key = materialClass(pos);
+	const MaterialCounters* counters = nullptr;
+	{
+		QReadLocker locker(&s_statsLock);
+		auto it = s_materialStats.constFind(key);
+		if (it != s_materialStats.constEnd())
+			counters = &it.value();
+	}
+	if (counters == nullptr)
+	{
+		QWriteLocker locker(&s_statsLock);
+		counters = &s_materialStats[key];
+	}
+
+	if (found)
+		counters->hits.fetchAndAddRelaxed(1);
+	else
+		counters->misses.fetchAndAddRelaxed(1);
+	counters->probeTime.fetchAndAddRelaxed(nsecs);
+}
+
+int tableSize(const QString& fileName)
+{
+	int size = 0;
+	for (const QChar& c : fileName)
+	{
+		if (c == QLatin1Char('.'))
+			break;
+		if (c != QLatin1Char('v'))
+			size++;
+	}
+
+	return size;
+}
+
+class TablebasePreloader : public QRunnable
+{
+	public:
+		explicit TablebasePreloader(const QStringList& files)
+			: m_files(files)
+		{
+		}
+
+		virtual void run()
+		{
+			QByteArray buffer(1 << 20, Qt::Uninitialized);
+			for (const QString& fileName : m_files)
+			{
+				QFile file(fileName);
+				if (!file.open(QIODevice::ReadOnly))
+					continue;
+
+				while (!s_stopPreload.load()
+				&&     file.read(buffer.data(), buffer.size()) > 0)
+					;
+				if (s_stopPreload.load())
+					return;
+			}
+		}
+
+	private:
+		const QStringList m_files;
+};
+
+void stopPreload()
+{
+	s_stopPreload.store(1);
+}
+
 } // anonymous namespace
 
 bool SyzygyTablebase::initialize(const QString& path)
@@ -45,10 +259,52 @@ bool SyzygyTablebase::initialize(const QString& path)
 
 	const auto nativePath = QDir::toNativeSeparators(path);
 	s_initOK = tb_init(nativePath.toStdString().c_str());
+#ifdef Q_OS_WIN
+	const QChar separator(';');
+#else
+	const QChar separator(':');
+#endif
+	if (s_initOK)
+		s_paths = nativePath.split(separator, QString::SkipEmptyParts);
 
 	return s_initOK;
 }
 
+void SyzygyTablebase::preload()
+{
+	static bool started = false;
+	if (!s_initOK || started)
+		return;
+	started = true;
+
+	const int maxPieces = qMin(s_pieces, int(TB_LARGEST));
+	const QStringList filters = { "*.rtbw", "*.rtbz" };
+	QMap<QString, QString> files;
+	for (const QString& path : s_paths)
+	{
+		const QDir dir(path);
+		for (const QString& name : dir.entryList(filters, QDir::Files))
+		{
+			const int size = tableSize(name);
+			if (size > maxPieces)
+				continue;
+
+			// Sort by table size, and WDL before DTZ tables
+			const QString sortKey = QString("%1%2%3")
+				.arg(size, 2, 10, QChar('0'))
+				.arg(name.endsWith(".rtbw") ? 0 : 1)
+				.arg(name);
+			files.insert(sortKey, dir.filePath(name));
+		}
+	}
+	if (files.isEmpty())
+		return;
+
+	qAddPostRoutine(stopPreload);
+	QThreadPool::globalInstance()->start(
+		new TablebasePreloader(files.values()));
+}
+
 bool SyzygyTablebase::tbAvailable(int pieces)
 {
 	return s_initOK && ((unsigned)pieces <= TB_LARGEST);
@@ -79,74 +335,111 @@ Chess::Result SyzygyTablebase::result(const Chess::Side& side,
 	if (pieces.size() > s_pieces)
 		return Chess::Result();
 
+	TbPosition pos(side, enpassantSq, pieces);
+
+	QElapsedTimer timer;
+	timer.start();
+	unsigned result = tb_probe_root(pos.white, pos.black, pos.kings,
+		pos.queens, pos.rooks, pos.bishops, pos.knights, pos.pawns,
+		rule50, 0, pos.ep, pos.wtm, nullptr);
+	addProbe(pos, timer, result != TB_RESULT_FAILED);
+
+	Chess::Side winner(Chess::Side::NoSide);
+	if (result == TB_RESULT_FAILED)
+		return Chess::Result();
+	if (result == TB_RESULT_CHECKMATE)
+		winner = (pos.wtm? Chess::Side::Black: Chess::Side::White);
+	else if (result != TB_RESULT_STALEMATE)
+		winner = wdlWinner(TB_GET_WDL(result), pos.wtm);
+
+	if (dtz != nullptr)
+		*dtz = TB_GET_DTZ(result);
+	return Chess::Result(Chess::Result::Adjudication, winner, "SyzygyTB");
+}
+
+Chess::Result SyzygyTablebase::wdlResult(const Chess::Side& side,
+					  const Chess::Square& enpassantSq,
+					  Castling castling,
+					  int rule50,
+					  const PieceList& pieces,
+					  quint64 key)
+{
+	if (!s_initOK)
+		return Chess::Result();
+	if (castling)
+		return Chess::Result();
+	if (pieces.size() > s_pieces)
+		return Chess::Result();
+	if (rule50 != 0)
+		return result(side, enpassantSq, castling, rule50, pieces);
+
 	bool wtm = (side == Chess::Side::White);
-	unsigned ep = (tbSquare(enpassantSq) < 0? 0: tbSquare(enpassantSq));
-	uint64_t white = 0, black = 0;
-	uint64_t kings = 0, queens = 0, rooks = 0, bishops = 0, knights = 0,
-		pawns = 0;
-	typedef QPair<Chess::Square, Chess::Piece> PcSq;
-	for (const PcSq& item : pieces)
+	unsigned wdl = TB_RESULT_FAILED;
+	bool cached = false;
 	{
-		if (tbSquare(item.first) < 0)
-			continue;
-		unsigned sq = tbSquare(item.first);
-		uint64_t bit = ((uint64_t)1 << sq);
-		if (item.second.side() == Chess::Side::White)
-			white |= bit;
-		else
-			black |= bit;
-		switch (item.second.type())
+		QReadLocker locker(&s_cacheLock);
+		auto it = s_wdlCache.constFind(key);
+		if (it != s_wdlCache.constEnd())
 		{
-		case Chess::WesternBoard::Pawn:
-			pawns |= bit; break;
-		case Chess::WesternBoard::Knight:
-			knights |= bit; break;
-		case Chess::WesternBoard::Bishop:
-			bishops |= bit; break;
-		case Chess::WesternBoard::Rook:
-			rooks |= bit; break;
-		case Chess::WesternBoard::Queen:
-			queens |= bit; break;
-		case Chess::WesternBoard::King:
-			kings |= bit; break;
+			wdl = it.value();
+			cached = true;
 		}
 	}
 
-	s_mutex.lock();
-	unsigned result = tb_probe_root(white, black, kings, queens, rooks,
-		bishops, knights, pawns, rule50, 0, ep, wtm, nullptr);
-	s_mutex.unlock();
+	if (cached)
+		s_cacheHitCount.fetchAndAddRelaxed(1);
+	else
+	{
+		TbPosition pos(side, enpassantSq, pieces);
 
-	Chess::Side winner(Chess::Side::NoSide); 
-	if (result == TB_RESULT_FAILED)
+		QElapsedTimer timer;
+		timer.start();
+		wdl = tb_probe_wdl(pos.white, pos.black, pos.kings,
+			pos.queens, pos.rooks, pos.bishops, pos.knights, pos.pawns,
+			0, 0, pos.ep, pos.wtm);
+		addProbe(pos, timer, wdl != TB_RESULT_FAILED);
+
+		QWriteLocker locker(&s_cacheLock);
+		if (s_wdlCache.size() >= s_maxCacheSize)
+			s_wdlCache.clear();
+		s_wdlCache.insert(key, wdl);
+	}
+
+	if (wdl == TB_RESULT_FAILED)
 		return Chess::Result();
-	if (result == TB_RESULT_CHECKMATE)
-		winner = (wtm? Chess::Side::Black: Chess::Side::White);
-	else if (result == TB_RESULT_STALEMATE)
-		winner = Chess::Side::NoSide;
-	else
+	return Chess::Result(Chess::Result::Adjudication,
+			     wdlWinner(wdl, wtm), "SyzygyTB");
+}
+
+quint64 SyzygyTablebase::probeCount()
+{
+	return s_probeCount.load();
+}
+
+quint64 SyzygyTablebase::cacheHitCount()
+{
+	return s_cacheHitCount.load();
+}
+
+qint64 SyzygyTablebase::probeTime()
+{
+	return s_probeTime.load();
+}
+
+QList<SyzygyTablebase::MaterialStatistics> SyzygyTablebase::materialStatistics()
+{
+	QMap<QString, MaterialStatistics> stats;
+	QReadLocker locker(&s_statsLock);
+	for (auto it = s_materialStats.constBegin();
+	     it != s_materialStats.constEnd(); ++it)
 	{
-		switch (TB_GET_WDL(result))
-		{
-		case TB_BLESSED_LOSS:
-			if (!s_noRule50)
-				break;
-			// Fallthrough
-		case TB_LOSS:
-			winner = (wtm? Chess::Side::Black: Chess::Side::White);
-			break;
-		case TB_DRAW:
-			break;
-		case TB_CURSED_WIN:
-			if (!s_noRule50)
-				break;
-			// Fallthrough
-		case TB_WIN:
-			winner = (wtm? Chess::Side::White: Chess::Side::Black);
-			break;
-		}
+		MaterialStatistics item;
+		item.material = materialClassName(it.key());
+		item.hits = it.value().hits.load();
+		item.misses = it.value().misses.load();
+		item.probeTime = it.value().probeTime.load();
+		stats.insert(item.material, item);
 	}
-	if (dtz != nullptr)
-		*dtz = TB_GET_DTZ(result);
-	return Chess::Result(Chess::Result::Adjudication, winner, "SyzygyTB");
+
+	return stats.values();
 }
@@ -21,6 +21,7 @@
 #include <QFlags>
 #include <QList>
 #include <QPair>
+#include <QString>
 #include "result.h"
 #include "square.h"
 #include "piece.h"
@@ -53,6 +54,19 @@ class LIB_EXPORT SyzygyTablebase
 		/*! Synonym for QList< QPair<Chess::Square, Chess::Piece> >. */
 		typedef QList< QPair<Chess::Square, Chess::Piece> > PieceList;
 
+		/*! Probe statistics for one material class, eg. "KRPvKR". */
+		struct MaterialStatistics
+		{
+			/*! The material class. */
+			QString material;
+			/*! Number of probes that found the position. */
+			quint64 hits;
+			/*! Number of probes that failed. */
+			quint64 misses;
+			/*! Total time spent in the probes, in nanoseconds. */
+			qint64 probeTime;
+		};
+
 		/*!
 		 * Initializes the tablebases.
 		 *
@@ -62,6 +76,17 @@ class LIB_EXPORT SyzygyTablebase
 		 * in \a paths.
 		 */
 		static bool initialize(const QString& paths);
+		/*!
+		 * Starts reading the tablebase files into the operating
+		 * system's file cache in a background thread, smallest
+		 * tables first.
+		 *
+		 * Only tables with at most setPieces() pieces are read, so
+		 * this function should be called after setPieces().
+		 * Preloading keeps the first probes of each endgame from
+		 * stalling the game on slow or networked disks.
+		 */
+		static void preload();
 		/*!
 		 * Returns true if complete tablebases for \a pieces pieces are
 		 * available; otherwise returns false.
@@ -87,6 +112,9 @@ class LIB_EXPORT SyzygyTablebase
 		 * If the position isn't found in the tablebases, a null result
 		 * is returned.
 		 *
+		 * This function is thread-safe and may be called concurrently
+		 * once the tablebases have been initialized.
+		 *
 		 * \sa Chess::Board::tablebaseResult()
 		 */
 		static Chess::Result result(const Chess::Side& side,
@@ -95,6 +123,35 @@ class LIB_EXPORT SyzygyTablebase
 					    int rule50,
 					    const PieceList& pieces,
 					    unsigned int* dtz = nullptr);
+		/*!
+		 * Returns the expected game result for a position using only
+		 * the win/draw/loss tables.
+		 *
+		 * The arguments are the same as in result(). \a key is the
+		 * position's zobrist key, which is used to cache the results
+		 * of all games played by this process.
+		 *
+		 * A WDL probe is only exact when \a rule50 is zero; for other
+		 * positions this function falls back to result().
+		 */
+		static Chess::Result wdlResult(const Chess::Side& side,
+					       const Chess::Square& enpassantSq,
+					       Castling castling,
+					       int rule50,
+					       const PieceList& pieces,
+					       quint64 key);
+
+		/*! Returns the number of tablebase probes made so far. */
+		static quint64 probeCount();
+		/*! Returns the number of probes answered by the WDL cache. */
+		static quint64 cacheHitCount();
+		/*! Returns the total time spent probing, in nanoseconds. */
+		static qint64 probeTime();
+		/*!
+		 * Returns the probe statistics of each material class that
+		 * has been probed so far, sorted by material class.
+		 */
+		static QList<MaterialStatistics> materialStatistics();
 
 	private:
 		SyzygyTablebase();
@@ -16,6 +16,8 @@
 */
 
 #include "westernboard.h"
+#include <cstring>
+#include <utility>
 #include <QStringList>
 #include "westernzobrist.h"
 #include "boardtransition.h"
@@ -35,6 +37,12 @@ WesternBoard::WesternBoard(WesternZobrist* zobrist)
 	  m_pawnHasDoubleStep(true),
 	  m_hasEnPassantCaptures(true),
 	  m_pawnAmbiguous(false),
+	  m_standardLegality(false),
+	  m_standardMoveNotation(false),
+	  m_pinData(),
+	  m_sanKey(0),
+	  m_sanMoves(nullptr),
+	  m_sanNextMoves(nullptr),
 	  m_zobrist(zobrist)
 {
 	setPieceType(Pawn, tr("pawn"), "P");
@@ -89,6 +97,21 @@ bool WesternBoard::variantHasChanneling(Side, int) const
 	return false;
 }
 
+bool WesternBoard::useBitboards() const
+{
+	return false;
+}
+
+bool WesternBoard::hasStandardLegality() const
+{
+	return false;
+}
+
+bool WesternBoard::hasStandardMoveNotation() const
+{
+	return true;
+}
+
 void WesternBoard::vInitialize()
 {
 	m_kingCanCapture = kingCanCapture();
@@ -134,6 +157,23 @@ void WesternBoard::vInitialize()
 	m_rookOffsets[3] = m_arwidth;
 
 	m_pawnAmbiguous = (pawnAmbiguity(FreeStep) > 1);
+
+	bool standardPawns = true;
+	for (const PawnStep& pStep: m_pawnSteps)
+	{
+		if ((pStep.type == FreeStep && pStep.file != 0)
+		||  (pStep.type == CaptureStep && qAbs(pStep.file) != 1))
+			standardPawns = false;
+	}
+	if (standardPawns
+	&&  pawnAmbiguity(FreeStep) == 1
+	&&  pawnAmbiguity(CaptureStep) == 2
+	&&  useBitboards())
+		enableBitboards();
+
+	m_standardLegality = hasStandardLegality();
+	m_standardMoveNotation = hasStandardMoveNotation();
+	m_pinData.key = ~key();
 }
 
 inline int WesternBoard::pawnPushOffset(const PawnStep& ps, int sign) const
@@ -183,14 +223,20 @@ QString WesternBoard::sanMoveString(const Move& move)
 	Piece capture = pieceAt(target);
 	Square square = chessSquare(source);
 
+	// Legal moves of this position and the next one may have been
+	// generated already by moveSequenceString()
+	const bool cached = (m_sanMoves != nullptr && m_sanKey == key());
+
 	char checkOrMate = 0;
 	makeMove(move);
 	if (inCheck(sideToMove()))
 	{
-		if (canMove())
-			checkOrMate = '+';
+		bool mate;
+		if (cached && m_sanNextMoves != nullptr)
+			mate = m_sanNextMoves->isEmpty();
 		else
-			checkOrMate = '#';
+			mate = !canMove();
+		checkOrMate = mate ? '#' : '+';
 	}
 	undoMove();
 
@@ -236,18 +282,25 @@ QString WesternBoard::sanMoveString(const Move& move)
 	if (piece.type() != Pawn)	// not pawn
 	{
 		str += pieceSymbol(piece).toUpper();
-		QVarLengthArray<Move> moves;
-		generateMoves(moves, piece.type());
+		MoveList moves;
+		if (!cached)
+			generateMoves(moves, piece.type());
+		const MoveList& candidates = cached ? *m_sanMoves : moves;
 
-		for (int i = 0; i < moves.size(); i++)
+		for (int i = 0; i < candidates.size(); i++)
 		{
-			const Move& move2 = moves[i];
+			const Move& move2 = candidates[i];
 			if (move2.sourceSquare() == 0
 			||  move2.sourceSquare() == source
 			||  move2.targetSquare() != target)
 				continue;
 
-			if (!vIsLegalMove(move2))
+			if (cached)
+			{
+				if (pieceAt(move2.sourceSquare()) != piece)
+					continue;
+			}
+			else if (!vIsLegalMove(move2))
 				continue;
 
 			Square square2(chessSquare(move2.sourceSquare()));
@@ -268,18 +321,76 @@ QString WesternBoard::sanMoveString(const Move& move)
 	str += squareString(target);
 
 	if (move.promotion() != Piece::NoPiece)
-		str += "=" + pieceSymbol(move.promotion()).toUpper();
+	{
+		str += QLatin1Char('=');
+		str += pieceSymbol(move.promotion()).toUpper();
+	}
 
 	if (checkOrMate != 0)
-		str += checkOrMate;
+		str += QLatin1Char(checkOrMate);
+
+	return str;
+}
+
+QString WesternBoard::moveSequenceString(const QVector<Move>& moves,
+					 MoveNotation notation)
+{
+	if (notation != StandardAlgebraic)
+		return Board::moveSequenceString(moves, notation);
+
+	// The legal moves of each position are generated only once:
+	// first to find the check/mate suffix of the previous move,
+	// then to disambiguate the next move.
+	MoveList lists[2];
+	MoveList* current = &lists[0];
+	MoveList* next = &lists[1];
+	legalMoves(*current);
+
+	QString str;
+	str.reserve(moves.size() * 8);
+
+	for (int i = 0; i < moves.size(); i++)
+	{
+		const Move& move = moves.at(i);
+		Q_ASSERT(current->contains(move));
+
+		makeMove(move);
+		legalMoves(*next);
+		undoMove();
+
+		m_sanKey = key();
+		m_sanMoves = current;
+		m_sanNextMoves = next;
+		if (i > 0)
+			str += QLatin1Char(' ');
+		str += sanMoveString(move);
+		m_sanMoves = nullptr;
+		m_sanNextMoves = nullptr;
+
+		makeMove(move);
+		std::swap(current, next);
+	}
+
+	for (int i = 0; i < moves.size(); i++)
+		undoMove();
 
 	return str;
 }
 
 Move WesternBoard::moveFromLanString(const QString& str)
 {
-	Move move(Board::moveFromLanString(str));
+	return castlingMoveFromLan(Board::moveFromLanString(str));
+}
+
+Move WesternBoard::moveFromLanBytes(const char* str, int length)
+{
+	if (!m_standardMoveNotation)
+		return moveFromLanString(QString::fromLatin1(str, length));
+	return castlingMoveFromLan(Board::moveFromLanBytes(str, length));
+}
 
+Move WesternBoard::castlingMoveFromLan(const Move& move) const
+{
 	Side side = sideToMove();
 	int source = move.sourceSquare();
 	int target = move.targetSquare();
@@ -302,29 +413,41 @@ Move WesternBoard::moveFromLanString(const QString& str)
 
 Move WesternBoard::moveFromSanString(const QString& str)
 {
-	if (str.length() < 2)
-		return Move();
+	MoveBytes bytes;
+	toMoveBytes(str, bytes);
+	return parseSanMove(bytes.constData(), bytes.size());
+}
 
-	QString mstr = str;
-	Side side = sideToMove();
+Move WesternBoard::moveFromSanBytes(const char* str, int length)
+{
+	if (!m_standardMoveNotation)
+		return Board::moveFromSanBytes(str, length);
+	return parseSanMove(str, length);
+}
 
+Move WesternBoard::parseSanMove(const char* str, int length)
+{
 	// Ignore check/mate/strong move/blunder notation
-	while (mstr.endsWith('+') || mstr.endsWith('#')
-	||     mstr.endsWith('!') || mstr.endsWith('?'))
+	while (length > 0
+	&&     (str[length - 1] == '+' || str[length - 1] == '#'
+	||      str[length - 1] == '!' || str[length - 1] == '?'))
 	{
-		mstr.chop(1);
+		length--;
 	}
 
-	if (mstr.length() < 2)
+	if (length < 2)
 		return Move();
 
+	const char* end = str + length;
+	Side side = sideToMove();
+
 	// Castling
-	if (mstr.startsWith("O-O"))
+	if (length >= 3 && qstrncmp(str, "O-O", 3) == 0)
 	{
 		CastlingSide cside;
-		if (mstr == "O-O")
+		if (length == 3)
 			cside = KingSide;
-		else if (mstr == "O-O-O")
+		else if (length == 5 && qstrncmp(str + 3, "-O", 2) == 0)
 			cside = QueenSide;
 		else
 			return Move();
@@ -341,16 +464,16 @@ Move WesternBoard::moveFromSanString(const QString& str)
 
 	Square sourceSq;
 	Square targetSq;
-	QString::const_iterator it = mstr.cbegin();
+	const char* it = str;
 
 	// A SAN move can't start with the capture mark, and
 	if (*it == 'x')
 		return Move();
 	// a pawn move should not specify the piece type
-	if (pieceFromSymbol(*it) == Pawn)
+	if (pieceFromSymbol(it, 1) == Pawn)
 		it++; // ignore character
 	// Piece type
-	Piece piece = pieceFromSymbol(*it);
+	Piece piece = (it != end) ? pieceFromSymbol(it, 1) : Piece();
 	if (piece.side() != Side::White)
 		piece = Piece::NoPiece;
 	else
@@ -358,7 +481,7 @@ Move WesternBoard::moveFromSanString(const QString& str)
 	if (piece.isEmpty())
 	{
 		piece = Piece(side, Pawn);
-		targetSq = chessSquare(mstr.mid(0, 2));
+		targetSq = chessSquare(str, 2);
 		if (isValidSquare(targetSq))
 			it += 2;
 	}
@@ -367,9 +490,9 @@ Move WesternBoard::moveFromSanString(const QString& str)
 		++it;
 
 		// Drop moves
-		if (*it == '@')
+		if (it != end && *it == '@')
 		{
-			targetSq = chessSquare(mstr.right(2));
+			targetSq = chessSquare(end - 2, 2);
 			if (!isValidSquare(targetSq))
 				return Move();
 
@@ -385,21 +508,21 @@ Move WesternBoard::moveFromSanString(const QString& str)
 	if (!isValidSquare(targetSq))
 	{
 		// Source square's file
-		sourceSq.setFile(it->toLatin1() - 'a');
+		sourceSq.setFile(it != end ? *it - 'a' : -1);
 		if (sourceSq.file() < 0 || sourceSq.file() >= width())
 			sourceSq.setFile(-1);
-		else if (++it == mstr.cend())
+		else if (++it == end)
 			return Move();
 
 		// Source square's rank
-		if (it->isDigit())
+		if (it != end && *it >= '0' && *it <= '9')
 		{
-			sourceSq.setRank(it->toLatin1() - '1');
+			sourceSq.setRank(*it - '1');
 			if (sourceSq.rank() < 0 || sourceSq.rank() >= height())
 				return Move();
 			++it;
 		}
-		if (it == mstr.cend())
+		if (it == end)
 		{
 			// What we thought was the source square, was
 			// actually the target square.
@@ -415,7 +538,7 @@ Move WesternBoard::moveFromSanString(const QString& str)
 		// Capture
 		else if (*it == 'x')
 		{
-			if(++it == mstr.cend())
+			if (++it == end)
 				return Move();
 			stringIsCapture = true;
 		}
@@ -423,9 +546,9 @@ Move WesternBoard::moveFromSanString(const QString& str)
 		// Target square
 		if (!isValidSquare(targetSq))
 		{
-			if (it + 1 == mstr.cend())
+			if (it + 1 == end)
 				return Move();
-			targetSq = chessSquare(mstr.mid(it - mstr.cbegin(), 2));
+			targetSq = chessSquare(it, 2);
 			it += 2;
 		}
 	}
@@ -444,57 +567,98 @@ Move WesternBoard::moveFromSanString(const QString& str)
 
 	// Promotion
 	int promotion = Piece::NoPiece;
-	if (it != mstr.cend())
+	if (it != end)
 	{
-		if ((*it == '=' || *it == '(') && ++it == mstr.cend())
+		if ((*it == '=' || *it == '(') && ++it == end)
 			return Move();
 
-		promotion = pieceFromSymbol(*it).type();
+		promotion = pieceFromSymbol(it, 1).type();
 		if (promotion == Piece::NoPiece)
 			return Move();
 	}
 
-	QVarLengthArray<Move> moves;
-	generateMoves(moves, piece.type());
-	const Move* match = nullptr;
+	// Castling moves were handled earlier
+	if (pieceAt(target) == Piece(side, Rook))
+		return Move();
 
-	// Loop through all legal moves to find a move that matches
-	// the data we got from the move string.
-	for (int i = 0; i < moves.size(); i++)
+	// Look back from the target square for the pieces that could
+	// have made the move. With bitboards only the pieces that attack
+	// the target square are candidates, otherwise every piece of the
+	// right type is.
+	QVarLengthArray<int, 16> sources;
+	if (hasBitboards() && piece.type() == Pawn)
 	{
-		const Move& move = moves[i];
-		if (move.sourceSquare() == 0 || move.targetSquare() != target)
-			continue;
-		Square sourceSq2 = chessSquare(move.sourceSquare());
+		for (const PawnStep& pStep: m_pawnSteps)
+		{
+			int offset = pawnPushOffset(pStep, m_sign);
+			if (pieceAt(target - offset) == piece)
+				sources.append(target - offset);
+			if (pStep.type == FreeStep
+			&&  m_pawnHasDoubleStep
+			&&  pieceAt(target - offset * 2) == piece)
+				sources.append(target - offset * 2);
+		}
+	}
+	else if (hasBitboards())
+	{
+		int sq = BitboardAttacks::fromIndex(target);
+		Bitboard attacks = 0;
+		if (piece.type() == King)
+			attacks = BitboardAttacks::kingAttacks(sq);
+		else
+		{
+			Bitboard occupied = occupiedBitboard();
+			if (pieceHasMovement(piece.type(), KnightMovement))
+				attacks |= BitboardAttacks::knightAttacks(sq);
+			if (pieceHasMovement(piece.type(), BishopMovement))
+				attacks |= BitboardAttacks::bishopAttacks(sq, occupied);
+			if (pieceHasMovement(piece.type(), RookMovement))
+				attacks |= BitboardAttacks::rookAttacks(sq, occupied);
+		}
+
+		attacks &= pieceBitboard(side, piece.type());
+		while (attacks)
+			sources.append(BitboardAttacks::toIndex(
+				BitboardAttacks::popLsb(attacks)));
+	}
+	else
+	{
+		for (const int sq: pieceSquares(side))
+		{
+			if (pieceAt(sq) == piece)
+				sources.append(sq);
+		}
+	}
+
+	Move match;
+	for (const int source: sources)
+	{
+		Square sourceSq2 = chessSquare(source);
 		if (sourceSq.rank() != -1 && sourceSq2.rank() != sourceSq.rank())
 			continue;
 		if (sourceSq.file() != -1 && sourceSq2.file() != sourceSq.file())
 			continue;
-		// Castling moves were handled earlier
-		if (pieceAt(target) == Piece(side, Rook))
-			continue;
-		if (move.promotion() != promotion)
-			continue;
 
-		if (!vIsLegalMove(move))
+		// Only the candidate moves are generated and tested,
+		// unless the legal moves are already cached
+		Move move(source, target, promotion);
+		if (!isLegalMove(move))
 			continue;
 
 		// Return an empty move if there are multiple moves that
 		// match the move string.
-		if (match != nullptr)
+		if (!match.isNull())
 			return Move();
-		match = &move;
+		match = move;
 	}
 
-	if (match != nullptr)
-		return *match;
-
-	return Move();
+	return match;
 }
 
-QString WesternBoard::castlingRightsString(FenNotation notation) const
+void WesternBoard::appendCastlingRights(FenBuffer& buffer,
+					FenNotation notation) const
 {
-	QString str;
+	int start = buffer.length();
 
 	for (int side = Side::White; side <= Side::Black; side++)
 	{
@@ -521,11 +685,11 @@ QString WesternBoard::castlingRightsString(FenNotation notation) const
 				i += offset;
 			}
 
-			QChar c;
+			char c;
 			// If the castling square is ambiguous, then we can't
 			// use 'K' or 'Q'. Instead we'll use the square's file.
 			if (ambiguous || notation == ShredderFen)
-				c = QChar('a' + chessSquare(rs).file());
+				c = char('a' + chessSquare(rs).file());
 			else
 			{
 				if (cside == 0)
@@ -534,14 +698,13 @@ QString WesternBoard::castlingRightsString(FenNotation notation) const
 					c = 'k';
 			}
 			if (side == upperCaseSide())
-				c = c.toUpper();
-			str += c;
+				c = char(c - 'a' + 'A');
+			buffer.append(c);
 		}
 	}
 
-	if (str.length() == 0)
-		str = "-";
-	return str;
+	if (buffer.length() == start)
+		buffer.append('-');
 }
 
 int WesternBoard::pawnAmbiguity(StepType t) const
@@ -562,31 +725,43 @@ QString WesternBoard::vFenIncludeString(FenNotation notation) const
 }
 
 QString WesternBoard::vFenString(FenNotation notation) const
+{
+	QVarLengthArray<char, 64> buffer(64);
+	for (;;)
+	{
+		FenBuffer fen(buffer.data(), buffer.size());
+		WesternBoard::vFenBytes(fen, notation);
+		if (fen.isValid())
+			return QString::fromLatin1(buffer.constData(), fen.length());
+		buffer.resize(fen.length());
+	}
+}
+
+void WesternBoard::vFenBytes(FenBuffer& buffer, FenNotation notation) const
 {
 	// Castling rights
-	QString fen = castlingRightsString(notation) + ' ';
+	appendCastlingRights(buffer, notation);
+	buffer.append(' ');
 
 	// En-passant square
 	if (m_enpassantSquare != 0)
 	{
-		fen += squareString(m_enpassantSquare);
+		appendSquareString(buffer, m_enpassantSquare);
 		if (m_pawnAmbiguous)
-			fen += squareString(m_enpassantTarget);
+			appendSquareString(buffer, m_enpassantTarget);
 	}
 	else
-		fen += '-';
+		buffer.append('-');
 
-	fen +=vFenIncludeString(notation);
+	buffer.append(vFenIncludeString(notation));
 
 	// Reversible halfmove count
-	fen += ' ';
-	fen += QString::number(m_reversibleMoveCount);
+	buffer.append(' ');
+	buffer.appendNumber(m_reversibleMoveCount);
 
 	// Full move number
-	fen += ' ';
-	fen += QString::number(m_history.size() / 2 + 1);
-
-	return fen;
+	buffer.append(' ');
+	buffer.appendNumber(plyCount() / 2 + 1);
 }
 
 bool WesternBoard::parseCastlingRights(QChar c)
@@ -776,7 +951,6 @@ bool WesternBoard::vSetFenString(const QStringList& fen)
 
 	// The full move number is ignored. It's rarely useful
 
-	m_history.clear();
 	return true;
 }
 
@@ -853,8 +1027,14 @@ void WesternBoard::vMakeMove(const Move& move, BoardTransition* transition)
 
 	Q_ASSERT(target != 0);
 
-	MoveData md = { capture, epSq, epTgt, m_castlingRights,
-			NoCastlingSide, m_reversibleMoveCount };
+	MoveState& md = moveState();
+	md.capture = capture;
+	md.enpassantSquare = epSq;
+	md.enpassantTarget = epTgt;
+	std::memcpy(md.castlingRights, m_castlingRights.rookSquare,
+		    sizeof(md.castlingRights));
+	md.castlingSide = NoCastlingSide;
+	md.reversibleMoveCount = m_reversibleMoveCount;
 
 	if (source == 0)
 	{
@@ -970,13 +1150,12 @@ void WesternBoard::vMakeMove(const Move& move, BoardTransition* transition)
 	else
 		m_reversibleMoveCount = 0;
 
-	m_history.append(md);
 	m_sign *= -1;
 }
 
 void WesternBoard::vUndoMove(const Move& move)
 {
-	const MoveData& md = m_history.last();
+	const MoveState& md = moveState();
 	int source = move.sourceSquare();
 	int target = move.targetSquare();
 
@@ -985,9 +1164,10 @@ void WesternBoard::vUndoMove(const Move& move)
 
 	setEnpassantSquare(md.enpassantSquare, md.enpassantTarget);
 	m_reversibleMoveCount = md.reversibleMoveCount;
-	m_castlingRights = md.castlingRights;
+	std::memcpy(m_castlingRights.rookSquare, md.castlingRights,
+		    sizeof(md.castlingRights));
 
-	CastlingSide cside = md.castlingSide;
+	CastlingSide cside = CastlingSide(md.castlingSide);
 	if (cside != NoCastlingSide)
 	{
 		m_kingSquare[side] = source;
@@ -999,7 +1179,6 @@ void WesternBoard::vUndoMove(const Move& move)
 
 		setSquare(target, Piece(side, Rook));
 		setSquare(source, Piece(side, King));
-		m_history.pop_back();
 		return;
 	}
 	else if (target == m_kingSquare[side])
@@ -1027,15 +1206,16 @@ void WesternBoard::vUndoMove(const Move& move)
 		setSquare(source, pieceAt(target));
 
 	setSquare(target, md.capture);
-	m_history.pop_back();
 }
 
-void WesternBoard::generateMovesForPiece(QVarLengthArray<Move>& moves,
+void WesternBoard::generateMovesForPiece(MoveList& moves,
 					 int pieceType,
 					 int square) const
 {
 	if (pieceType == Pawn)
 		return generatePawnMoves(square, moves);
+	if (hasBitboards())
+		return generateBitboardMoves(square, pieceType, moves);
 	if (pieceType == King)
 	{
 		generateHoppingMoves(square, m_bishopOffsets, moves);
@@ -1052,6 +1232,37 @@ void WesternBoard::generateMovesForPiece(QVarLengthArray<Move>& moves,
 		generateSlidingMoves(square, m_rookOffsets, moves);
 }
 
+void WesternBoard::generateBitboardMoves(int sourceSquare,
+					 int pieceType,
+					 MoveList& moves) const
+{
+	int sq = BitboardAttacks::fromIndex(sourceSquare);
+	Bitboard targets = 0;
+
+	if (pieceType == King)
+		targets = BitboardAttacks::kingAttacks(sq);
+	else
+	{
+		Bitboard occupied = occupiedBitboard();
+		if (pieceHasMovement(pieceType, KnightMovement))
+			targets |= BitboardAttacks::knightAttacks(sq);
+		if (pieceHasMovement(pieceType, BishopMovement))
+			targets |= BitboardAttacks::bishopAttacks(sq, occupied);
+		if (pieceHasMovement(pieceType, RookMovement))
+			targets |= BitboardAttacks::rookAttacks(sq, occupied);
+	}
+
+	targets &= ~sideBitboard(sideToMove());
+	while (targets)
+	{
+		int target = BitboardAttacks::toIndex(BitboardAttacks::popLsb(targets));
+		moves.append(Move(sourceSquare, target));
+	}
+
+	if (pieceType == King)
+		generateCastlingMoves(moves);
+}
+
 bool WesternBoard::inCheck(Side side, int square) const
 {
 	Side opSide = side.opposite();
@@ -1063,6 +1274,9 @@ bool WesternBoard::inCheck(Side side, int square) const
 			return false;
 	}
 
+	if (hasBitboards())
+		return bitboardInCheck(side, square);
+
 	// Pawn attacks
 	int sign = (side == Side::White) ? 1 : -1;
 
@@ -1133,13 +1347,188 @@ bool WesternBoard::inCheck(Side side, int square) const
 	return false;
 }
 
+bool WesternBoard::bitboardInCheck(Side side, int square) const
+{
+	int sq = BitboardAttacks::fromIndex(square);
+	return bitboardAttackers(side, sq, occupiedBitboard()) != 0;
+}
+
+Bitboard WesternBoard::bitboardAttackers(Side side,
+					 int square,
+					 Bitboard occupied) const
+{
+	Side opSide = side.opposite();
+	Bitboard attackers =
+		(BitboardAttacks::pawnAttacks(side, square)
+		 & pieceBitboard(opSide, Pawn))
+		| (BitboardAttacks::knightAttacks(square)
+		 & movementBitboard(opSide, KnightMovement))
+		| (BitboardAttacks::bishopAttacks(square, occupied)
+		 & movementBitboard(opSide, BishopMovement))
+		| (BitboardAttacks::rookAttacks(square, occupied)
+		 & movementBitboard(opSide, RookMovement));
+
+	if (m_kingCanCapture)
+		attackers |= BitboardAttacks::kingAttacks(square)
+			   & pieceBitboard(opSide, King);
+
+	return attackers;
+}
+
+Bitboard WesternBoard::dropTargets() const
+{
+	Q_ASSERT(hasBitboards());
+
+	Side side = sideToMove();
+	Bitboard occupied = occupiedBitboard();
+	Bitboard targets = ~occupied;
+	if (m_kingSquare[side] == 0)
+		return targets;
+
+	int kingSq = BitboardAttacks::fromIndex(m_kingSquare[side]);
+	Bitboard checkers = (m_pinData.key == key())
+		? m_pinData.checkers
+		: bitboardAttackers(side, kingSq, occupied);
+	if (!checkers)
+		return targets;
+	// A drop can't capture the checker or stop a double check
+	if (checkers & (checkers - 1))
+		return 0;
+
+	return targets & BitboardAttacks::between(kingSq,
+		BitboardAttacks::popLsb(checkers));
+}
+
+void WesternBoard::updatePinData()
+{
+	Side side = sideToMove();
+	Side opSide = side.opposite();
+	int kingSq = BitboardAttacks::fromIndex(m_kingSquare[side]);
+	Bitboard occupied = occupiedBitboard();
+
+	m_pinData.key = key();
+	m_pinData.checkers = bitboardAttackers(side, kingSq, occupied);
+	m_pinData.pinned = 0;
+
+	// Sliders that would attack the king through exactly one
+	// piece pin that piece if it belongs to the king's side.
+	Bitboard snipers =
+		(BitboardAttacks::bishopAttacks(kingSq, 0)
+		 & movementBitboard(opSide, BishopMovement))
+		| (BitboardAttacks::rookAttacks(kingSq, 0)
+		 & movementBitboard(opSide, RookMovement));
+	while (snipers)
+	{
+		int sq = BitboardAttacks::popLsb(snipers);
+		Bitboard blockers = BitboardAttacks::between(kingSq, sq) & occupied;
+		if (blockers && !(blockers & (blockers - 1)))
+			m_pinData.pinned |= blockers & sideBitboard(side);
+	}
+}
+
+bool WesternBoard::bitboardIsLegalMove(const Move& move)
+{
+	Side side = sideToMove();
+	int source = move.sourceSquare();
+	int target = move.targetSquare();
+
+	// In the "horde" variant the horde side has no king
+	if (m_kingSquare[side] == 0)
+		return true;
+
+	if (m_pinData.key != key())
+		updatePinData();
+
+	int kingSq = BitboardAttacks::fromIndex(m_kingSquare[side]);
+	int to = BitboardAttacks::fromIndex(target);
+	Bitboard toBit = BitboardAttacks::squareBit(to);
+	Bitboard checkers = m_pinData.checkers;
+	Bitboard occupied = occupiedBitboard();
+
+	if (source == m_kingSquare[side])
+	{
+		occupied ^= BitboardAttacks::squareBit(kingSq);
+
+		CastlingSide cside = castlingSide(move);
+		if (cside == NoCastlingSide)
+			return !(bitboardAttackers(side, to, occupied) & ~toBit);
+
+		// The king may not castle out of, through or into check.
+		// If the king stays on its square the move is left to
+		// isLegalPosition().
+		int kingTarget = m_castleTarget[side][cside];
+		if (kingTarget == source)
+			return Board::vIsLegalMove(move);
+		int rookTarget = (cside == QueenSide) ? kingTarget + 1 : kingTarget - 1;
+
+		occupied ^= toBit;
+		occupied |= BitboardAttacks::squareBit(BitboardAttacks::fromIndex(kingTarget))
+			 |  BitboardAttacks::squareBit(BitboardAttacks::fromIndex(rookTarget));
+
+		int offset = (source <= kingTarget) ? 1 : -1;
+		for (int i = source; ; i += offset)
+		{
+			int sq = BitboardAttacks::fromIndex(i);
+			if (bitboardAttackers(side, sq, occupied))
+				return false;
+			if (i == kingTarget)
+				return true;
+		}
+	}
+
+	// Only a king move can escape a double check
+	if (checkers & (checkers - 1))
+		return false;
+
+	// Piece drop
+	if (source == 0)
+	{
+		return !checkers
+		    || (BitboardAttacks::between(kingSq,
+			BitboardAttacks::popLsb(checkers)) & toBit);
+	}
+
+	int from = BitboardAttacks::fromIndex(source);
+
+	// An en-passant capture removes two pieces from the same rank,
+	// so it can expose the king in ways the pin data doesn't cover.
+	if (target == m_enpassantSquare
+	&&  pieceAt(source).type() == Pawn)
+	{
+		if (m_enpassantTarget == 0)
+			return Board::vIsLegalMove(move);
+
+		Bitboard capBit = BitboardAttacks::squareBit(
+			BitboardAttacks::fromIndex(m_enpassantTarget));
+		occupied ^= BitboardAttacks::squareBit(from) | capBit;
+		occupied |= toBit;
+		return !(bitboardAttackers(side, kingSq, occupied) & ~capBit);
+	}
+
+	if (checkers)
+	{
+		Bitboard bb = checkers;
+		int checkerSq = BitboardAttacks::popLsb(bb);
+		Bitboard evasions = checkers
+			| BitboardAttacks::between(kingSq, checkerSq);
+		if (!(evasions & toBit))
+			return false;
+	}
+
+	if ((m_pinData.pinned & BitboardAttacks::squareBit(from))
+	&&  !(BitboardAttacks::line(kingSq, from) & toBit))
+		return false;
+
+	return true;
+}
+
 bool WesternBoard::isLegalPosition()
 {
 	Side side = sideToMove().opposite();
 	if (inCheck(side))
 		return false;
 
-	if (m_history.isEmpty())
+	if (plyCount() == 0)
 		return true;
 
 	const Move& move = lastMove();
@@ -1147,7 +1536,7 @@ bool WesternBoard::isLegalPosition()
 	// Make sure that no square between the king's initial and final
 	// squares (including the initial and final squares) are under
 	// attack (in check) by the opponent.
-	CastlingSide cside = m_history.last().castlingSide;
+	CastlingSide cside = CastlingSide(moveState().castlingSide);
 	if (cside != NoCastlingSide)
 	{
 		int source = move.sourceSquare();
@@ -1190,12 +1579,15 @@ bool WesternBoard::vIsLegalMove(const Move& move)
 	&&  captureType(move) != Piece::NoPiece)
 		return false;
 
+	if (m_standardLegality && hasBitboards())
+		return bitboardIsLegalMove(move);
+
 	return Board::vIsLegalMove(move);
 }
 
 void WesternBoard::addPromotions(int sourceSquare,
 				 int targetSquare,
-				 QVarLengthArray<Move>& moves) const
+				 MoveList& moves) const
 {
 	moves.append(Move(sourceSquare, targetSquare, Knight));
 	moves.append(Move(sourceSquare, targetSquare, Bishop));
@@ -1204,7 +1596,7 @@ void WesternBoard::addPromotions(int sourceSquare,
 }
 
 void WesternBoard::generatePawnMoves(int sourceSquare,
-				     QVarLengthArray<Move>& moves) const
+				     MoveList& moves) const
 {
 	int targetSquare;
 	Piece capture;
@@ -1299,7 +1691,7 @@ bool WesternBoard::canCastle(CastlingSide castlingSide) const
 	return true;
 }
 
-void WesternBoard::generateCastlingMoves(QVarLengthArray<Move>& moves) const
+void WesternBoard::generateCastlingMoves(MoveList& moves) const
 {
 	Side side = sideToMove();
 	int source = m_kingSquare[side];
@@ -1358,32 +1750,33 @@ Result WesternBoard::result()
 	// Insufficient mating material
 	int material = 0;
 	bool bishops[] = { false, false };
-	for (int i = 0; i < arraySize(); i++)
+	for (int i = 0; i < 2 && material <= 1; i++)
 	{
-		const Piece& piece = pieceAt(i);
-		if (!piece.isValid())
-			continue;
-
-		switch (piece.type())
-		{
-		case King:
-			break;
-		case Bishop:
+		for (const int sq: pieceSquares(Side::Type(i)))
 		{
-			auto color = chessSquare(i).color();
-			if (color != Square::NoColor && !bishops[color])
+			switch (pieceAt(sq).type())
 			{
+			case King:
+				break;
+			case Bishop:
+			{
+				auto color = chessSquare(sq).color();
+				if (color != Square::NoColor && !bishops[color])
+				{
+					material++;
+					bishops[color] = true;
+				}
+				break;
+			}
+			case Knight:
 				material++;
-				bishops[color] = true;
+				break;
+			default:
+				material += 2;
+				break;
 			}
-			break;
-		}
-		case Knight:
-			material++;
-			break;
-		default:
-			material += 2;
-			break;
+			if (material > 1)
+				break;
 		}
 	}
 	if (material <= 1)
@@ -59,6 +59,8 @@ class LIB_EXPORT WesternBoard : public Board
 		virtual int height() const;
 		virtual Result result();
 		virtual int reversibleMoveCount() const;
+		virtual QString moveSequenceString(const QVector<Move>& moves,
+						   MoveNotation notation);
 
 	protected:
 		/*! The king's castling side. */
@@ -134,6 +136,39 @@ class LIB_EXPORT WesternBoard : public Board
 		 * The default value is the value of pawnHasDoubleStep().
 		 */
 		virtual bool hasEnPassantCaptures() const;
+		/*!
+		 * Returns true if the variant can use bitboards for generating
+		 * moves and detecting checks. The default value is false.
+		 *
+		 * Bitboards are only used on 8x8 boards where pawns move like
+		 * in standard chess; the mailbox move generator is used
+		 * otherwise.
+		 * \sa StandardBoard
+		 */
+		virtual bool useBitboards() const;
+		/*!
+		 * Returns true if a move is legal exactly when it doesn't
+		 * leave the king in check or make it castle out of or
+		 * through check. The default value is false.
+		 *
+		 * When this is true and the board has bitboards, move
+		 * legality is decided from the checking and pinned pieces
+		 * of the position instead of making and undoing each move.
+		 * Variants that override inCheck(), isLegalPosition() or
+		 * change how captures work must return false.
+		 * \sa StandardBoard
+		 */
+		virtual bool hasStandardLegality() const;
+		/*!
+		 * Returns true if the variant reads SAN and LAN move strings
+		 * exactly like WesternBoard does. The default value is true.
+		 *
+		 * When this is true, moveFromString(const char*, int) parses
+		 * the bytes directly instead of going through a QString.
+		 * Variants that reimplement moveFromSanString() or
+		 * moveFromLanString() must return false.
+		 */
+		virtual bool hasStandardMoveNotation() const;
 		/*!
 		 * Returns true if a rule provides \a side to insert a reserve
 		 * piece at a vacated source \a square immediately after a move.
@@ -152,7 +187,7 @@ class LIB_EXPORT WesternBoard : public Board
 		 */
 		virtual void addPromotions(int sourceSquare,
 					   int targetSquare,
-					   QVarLengthArray<Move>& moves) const;
+					   MoveList& moves) const;
 		/*! Returns the king square of \a side. */
 		int kingSquare(Side side) const;
 		/*! Returns the current en-passant square. */
@@ -192,6 +227,15 @@ class LIB_EXPORT WesternBoard : public Board
 		 * If \a square is 0, then the king square is used.
 		 */
 		virtual bool inCheck(Side side, int square = 0) const;
+		/*!
+		 * Returns the squares where the side to move can legally
+		 * drop a piece: the empty squares, or only the squares
+		 * between the king and the checking piece if the king is in
+		 * check. Returns an empty set in double check.
+		 *
+		 * \note Requires bitboards, see hasBitboards().
+		 */
+		Bitboard dropTargets() const;
 
 		/*!
 		 * Returns FEN extensions. The default is an empty string.
@@ -205,15 +249,19 @@ class LIB_EXPORT WesternBoard : public Board
 		// Inherited from Board
 		virtual void vInitialize();
 		virtual QString vFenString(FenNotation notation) const;
+		virtual void vFenBytes(FenBuffer& buffer,
+				       FenNotation notation) const;
 		virtual bool vSetFenString(const QStringList& fen);
 		virtual QString lanMoveString(const Move& move);
 		virtual QString sanMoveString(const Move& move);
 		virtual Move moveFromLanString(const QString& str);
 		virtual Move moveFromSanString(const QString& str);
+		virtual Move moveFromLanBytes(const char* str, int length);
+		virtual Move moveFromSanBytes(const char* str, int length);
 		virtual void vMakeMove(const Move& move,
 				       BoardTransition* transition);
 		virtual void vUndoMove(const Move& move);
-		virtual void generateMovesForPiece(QVarLengthArray<Move>& moves,
+		virtual void generateMovesForPiece(MoveList& moves,
 						   int pieceType,
 						   int square) const;
 		virtual bool vIsLegalMove(const Move& move);
@@ -228,23 +276,33 @@ class LIB_EXPORT WesternBoard : public Board
 			int rookSquare[2][2];
 		};
 
-		// Data for reversing/unmaking a move
-		struct MoveData
+		// Checking and pinned pieces of the side to move
+		struct PinData
 		{
-			Piece capture;
-			int enpassantSquare;
-			int enpassantTarget;
-			CastlingRights castlingRights;
-			CastlingSide castlingSide;
-			int reversibleMoveCount;
+			quint64 key;
+			Bitboard checkers;
+			Bitboard pinned;
 		};
 
-		void generateCastlingMoves(QVarLengthArray<Move>& moves) const;
+		void generateCastlingMoves(MoveList& moves) const;
 		void generatePawnMoves(int sourceSquare,
-				       QVarLengthArray<Move>& moves) const;
+				       MoveList& moves) const;
+		void generateBitboardMoves(int sourceSquare,
+					   int pieceType,
+					   MoveList& moves) const;
+		bool bitboardInCheck(Side side, int square) const;
+		Bitboard bitboardAttackers(Side side,
+					   int square,
+					   Bitboard occupied) const;
+		void updatePinData();
+		bool bitboardIsLegalMove(const Move& move);
+
+		Move castlingMoveFromLan(const Move& move) const;
+		Move parseSanMove(const char* str, int length);
 
 		bool canCastle(CastlingSide castlingSide) const;
-		QString castlingRightsString(FenNotation notation) const;
+		void appendCastlingRights(FenBuffer& buffer,
+					  FenNotation notation) const;
 		CastlingSide castlingSide(const Move& move) const;
 		void setEnpassantSquare(int square,
 					int target=0);
@@ -267,14 +325,19 @@ class LIB_EXPORT WesternBoard : public Board
 		bool m_pawnHasDoubleStep;
 		bool m_hasEnPassantCaptures;
 		bool m_pawnAmbiguous;
-		QVector<MoveData> m_history;
+		bool m_standardLegality;
+		bool m_standardMoveNotation;
+		PinData m_pinData;
+		quint64 m_sanKey;
+		const MoveList* m_sanMoves;
+		const MoveList* m_sanNextMoves;
 		CastlingRights m_castlingRights;
 		int m_castleTarget[2][2];
 		const WesternZobrist* m_zobrist;
 
-		QVarLengthArray<int> m_knightOffsets;
-		QVarLengthArray<int> m_bishopOffsets;
-		QVarLengthArray<int> m_rookOffsets;
+		QVector<int> m_knightOffsets;
+		QVector<int> m_bishopOffsets;
+		QVector<int> m_rookOffsets;
 };
 
 
@@ -17,6 +17,7 @@
 
 #include "chessengine.h"
 #include <QIODevice>
+#include <QMetaMethod>
 #include <QTimer>
 #include <QStringRef>
 #include <QtAlgorithms>
@@ -75,11 +76,17 @@ ChessEngine::ChessEngine(QObject* parent)
 	  m_pinging(false),
 	  m_whiteEvalPov(false),
 	  m_pondering(false),
+	  m_incrementalPosition(false),
 	  m_pingTimer(new QTimer(this)),
 	  m_quitTimer(new QTimer(this)),
 	  m_idleTimer(new QTimer(this)),
 	  m_protocolStartTimer(new QTimer(this)),
+	  m_outputTimer(new QTimer(this)),
 	  m_ioDevice(nullptr),
+	  m_lineBuffer(4096, '\0'),
+	  m_deviceWriteCount(0),
+	  m_deviceBytesWritten(0),
+	  m_tracing(0),
 	  m_restartMode(EngineConfiguration::RestartAuto)
 {
 	m_pingTimer->setSingleShot(true);
@@ -98,6 +105,11 @@ ChessEngine::ChessEngine(QObject* parent)
 	m_protocolStartTimer->setInterval(35000);
 	connect(m_protocolStartTimer, SIGNAL(timeout()),
 		this, SLOT(onProtocolStartTimeout()));
+
+	m_output.reserve(4096);
+	m_outputTimer->setSingleShot(true);
+	m_outputTimer->setInterval(0);
+	connect(m_outputTimer, SIGNAL(timeout()), this, SLOT(flushOutput()));
 }
 
 ChessEngine::~ChessEngine()
@@ -143,6 +155,7 @@ void ChessEngine::applyConfiguration(const EngineConfiguration& configuration)
 
 	m_whiteEvalPov = configuration.whiteEvalPov();
 	m_pondering = configuration.pondering();
+	m_incrementalPosition = configuration.incrementalPosition();
 	m_restartMode = configuration.restartMode();
 	setClaimsValidated(configuration.areClaimsValidated());
 
@@ -283,6 +296,21 @@ bool ChessEngine::pondering() const
 	return m_pondering;
 }
 
+bool ChessEngine::incrementalPosition() const
+{
+	return m_incrementalPosition;
+}
+
+quint64 ChessEngine::deviceWriteCount() const
+{
+	return m_deviceWriteCount.load();
+}
+
+quint64 ChessEngine::deviceBytesWritten() const
+{
+	return m_deviceBytesWritten.load();
+}
+
 void ChessEngine::endGame(const Chess::Result& result)
 {
 	ChessPlayer::endGame(result);
@@ -356,6 +384,7 @@ void ChessEngine::kill()
 
 	disconnect(m_ioDevice, SIGNAL(readChannelFinished()),
 		   this, SLOT(onCrashed()));
+	flushOutput();
 	m_ioDevice->close();
 
 	ChessPlayer::kill();
@@ -431,34 +460,116 @@ void ChessEngine::write(const QString& data, WriteMode mode)
 		return;
 	}
 
-	Q_ASSERT(m_ioDevice->isWritable());
-	emit debugMessage(QString(">%1(%2): %3")
-			  .arg(name())
-			  .arg(m_id)
-			  .arg(data));
+	const QByteArray line(data.toLatin1());
+	writeLine(line.constData(), line.size(), Unbuffered);
+}
+
+void ChessEngine::writeLine(const char* data, int length, WriteMode mode)
+{
+	if (state() == Disconnected)
+		return;
+	if (state() == NotStarted
+	||  (m_pinging && mode == Buffered))
+	{
+		m_writeBuffer.append(QString::fromLatin1(data, length));
+		return;
+	}
+
+	if (m_tracing.load())
+		emit debugMessage(QString(">%1(%2): %3")
+				  .arg(name())
+				  .arg(m_id)
+				  .arg(QString::fromLatin1(data, length)));
+
+	m_output.append(data, length);
+	m_output.append('\n');
+	if (!m_outputTimer->isActive())
+		m_outputTimer->start();
+}
+
+void ChessEngine::flushOutput()
+{
+	m_outputTimer->stop();
+	if (m_output.isEmpty())
+		return;
+	if (!m_ioDevice->isWritable())
+	{
+		m_output.resize(0);
+		return;
+	}
 
-	if (m_ioDevice->write(data.toLatin1() + "\n") == -1)
+	m_deviceWriteCount.fetchAndAddRelaxed(1);
+	if (m_ioDevice->write(m_output) == -1)
 		qWarning("Writing to engine %s(%d) failed",
 			 qUtf8Printable(name()), m_id);
+	else
+		m_deviceBytesWritten.fetchAndAddRelaxed(quint64(m_output.size()));
+
+	// Keep the buffer's capacity for the next turn
+	m_output.resize(0);
+}
+
+void ChessEngine::connectNotify(const QMetaMethod& signal)
+{
+	static const QMetaMethod debugSignal =
+		QMetaMethod::fromSignal(&ChessPlayer::debugMessage);
+	if (signal == debugSignal)
+		m_tracing.storeRelease(1);
+
+	ChessPlayer::connectNotify(signal);
+}
+
+void ChessEngine::disconnectNotify(const QMetaMethod& signal)
+{
+	static const QMetaMethod debugSignal =
+		QMetaMethod::fromSignal(&ChessPlayer::debugMessage);
+
+	// An invalid signal means that all signals were disconnected
+	if (signal == debugSignal || !signal.isValid())
+		m_tracing.storeRelease(isSignalConnected(debugSignal));
+
+	ChessPlayer::disconnectNotify(signal);
+}
+
+void ChessEngine::parseLine(const char* line, int length)
+{
+	parseLine(QString::fromUtf8(line, length));
 }
 
 void ChessEngine::onReadyRead()
 {
 	while (m_ioDevice->isReadable() && m_ioDevice->canReadLine())
 	{
-		QString line = QString(m_ioDevice->readLine());
-		if (line.endsWith('\n'))
-			line.chop(1);
-		if (line.endsWith('\r'))
-			line.chop(1);
-		if (line.isEmpty())
+		// Read the line into a reused buffer, growing it for
+		// lines that don't fit
+		int length = 0;
+		for (;;)
+		{
+			qint64 n = m_ioDevice->readLine(m_lineBuffer.data() + length,
+							m_lineBuffer.size() - length);
+			if (n <= 0)
+				break;
+			length += int(n);
+			if (m_lineBuffer.at(length - 1) == '\n'
+			||  length < m_lineBuffer.size() - 1)
+				break;
+			m_lineBuffer.resize(m_lineBuffer.size() * 2);
+		}
+
+		const char* line = m_lineBuffer.constData();
+		if (length > 0 && line[length - 1] == '\n')
+			length--;
+		if (length > 0 && line[length - 1] == '\r')
+			length--;
+		if (length == 0)
 			continue;
 
-		emit debugMessage(QString("<%1(%2): %3")
-				  .arg(name())
-				  .arg(m_id)
-				  .arg(line));
-		parseLine(line);
+		if (m_tracing.load())
+			emit debugMessage(QString("<%1(%2): %3")
+					  .arg(name())
+					  .arg(m_id)
+					  .arg(QString::fromUtf8(line, length)));
+		parseLine(line, length);
 
 		if (m_idleTimer->isActive())
 		{
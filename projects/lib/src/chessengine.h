@@ -21,6 +21,7 @@
 #include "chessplayer.h"
 #include <QVariant>
 #include <QStringList>
+#include <QAtomicInteger>
 #include "engineconfiguration.h"
 
 class QIODevice;
@@ -34,6 +35,9 @@ class EngineOption;
  * either the Xboard or Uci chess protocol. Communication between the GUI
  * and the chess engines happens via a QIODevice.
  *
+ * The lines sent to and read from the engine are emitted with the
+ * debugMessage() signal, but only while that signal is connected.
+ *
  * \sa XboardEngine
  * \sa UciEngine
  */
@@ -98,10 +102,22 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 		/*!
 		 * Writes text data to the chess engine.
 		 *
-		 * If \a mode is \a Unbuffered, the data will be written to
-		 * the device immediately even if the engine is being pinged.
+		 * If \a mode is \a Unbuffered, the data will be sent to the
+		 * engine even if the engine is being pinged.
+		 *
+		 * All lines written during one turn of the event loop are
+		 * sent to the device together in a single write.
 		 */
 		void write(const QString& data, WriteMode mode = Buffered);
+		/*!
+		 * Writes a line of \a length bytes from \a data to the chess
+		 * engine without converting it from a QString.
+		 *
+		 * The line break is added by this function. \a mode works
+		 * the same way as in write().
+		 */
+		void writeLine(const char* data, int length,
+			       WriteMode mode = Buffered);
 
 		/*!
 		 * Sets an option with the name \a name to \a value.
@@ -166,6 +182,20 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 
 		/*! Parses a line of input from the engine. */
 		virtual void parseLine(const QString& line) = 0;
+		/*!
+		 * Parses a line of input from the engine that is \a length
+		 * bytes long, without the line break.
+		 *
+		 * This function is called for every line the engine sends.
+		 * The default implementation converts the line to a QString
+		 * and calls parseLine(const QString&). Subclasses can parse
+		 * frequent messages in place with EngineToken instead.
+		 */
+		virtual void parseLine(const char* line, int length);
+
+		// Inherited from QObject
+		virtual void connectNotify(const QMetaMethod& signal);
+		virtual void disconnectNotify(const QMetaMethod& signal);
 
 		/*!
 		 * Sends a ping command to the engine.
@@ -228,6 +258,18 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 		 * the engine does not support pondering.
 		 */
 		bool pondering() const;
+		/*!
+		 * Returns true if the engine accepts incremental position
+		 * updates; otherwise returns false.
+		 *
+		 * \sa EngineConfiguration::incrementalPosition()
+		 */
+		bool incrementalPosition() const;
+
+		/*! Returns the number of writes made to the engine's device. */
+		quint64 deviceWriteCount() const;
+		/*! Returns the number of bytes written to the engine's device. */
+		quint64 deviceBytesWritten() const;
 
 	protected slots:
 		// Inherited from ChessPlayer
@@ -271,6 +313,7 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 	private slots:
 		void onQuitTimeout();
 		void onProtocolStartTimeout();
+		void flushOutput();
 
 	private:
 		static int s_count;
@@ -280,11 +323,18 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 		bool m_pinging;
 		bool m_whiteEvalPov;
 		bool m_pondering;
+		bool m_incrementalPosition;
 		QTimer* m_pingTimer;
 		QTimer* m_quitTimer;
 		QTimer* m_idleTimer;
 		QTimer* m_protocolStartTimer;
+		QTimer* m_outputTimer;
 		QIODevice *m_ioDevice;
+		QByteArray m_lineBuffer;
+		QByteArray m_output;
+		QAtomicInteger<quint64> m_deviceWriteCount;
+		QAtomicInteger<quint64> m_deviceBytesWritten;
+		QAtomicInt m_tracing;
 		QStringList m_writeBuffer;
 		QStringList m_variants;
 		QList<EngineOption*> m_options;
@@ -16,6 +16,7 @@
 */
 
 #include "chessgame.h"
+#include <QMetaMethod>
 #include <QThread>
 #include <QTimer>
 #include <QtMath>
@@ -26,6 +27,40 @@
 #include "openingbook.h"
 #include "chessengine.h"
 #include "engineoption.h"
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace {
+
+// Returns the CPU time used by the current thread in nanoseconds
+qint64 threadCpuTime()
+{
+#ifdef Q_OS_WIN
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime,
+			    &kernelTime, &userTime))
+		return 0;
+
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+
+	// FILETIME values are in 100 nanosecond units
+	return qint64(kernel.QuadPart + user.QuadPart) * 100;
+#else
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+		return 0;
+	return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+} // anonymous namespace
 
 QString ChessGame::evalString(const MoveEvaluation& eval, const Chess::Move& move)
 {
@@ -276,6 +311,8 @@ ChessGame::ChessGame(Chess::Board* board, PgnGame* pgn, QObject* parent)
 	  m_pgnInitialized(false),
 	  m_bookOwnership(false),
 	  m_boardShouldBeFlipped(false),
+	  m_moveCpuTime(0),
+	  m_moveCpuCount(0),
 	  m_pgn(pgn)
 {
 	Q_ASSERT(pgn != nullptr);
@@ -356,6 +393,13 @@ Chess::Result ChessGame::result() const
 	return m_result;
 }
 
+qint64 ChessGame::moveCpuTime() const
+{
+	if (m_moveCpuCount == 0)
+		return 0;
+	return m_moveCpuTime / m_moveCpuCount;
+}
+
 ChessPlayer* ChessGame::playerToMove() const
 {
 	if (m_board->sideToMove().isNull())
@@ -402,7 +446,9 @@ void ChessGame::stop(bool emitMoveChanged)
 	if (emitMoveChanged && plies > 1)
 	{
 		const PgnGame::MoveData& md(moves.at(plies - 1));
-		emit moveChanged(plies - 1, md.move, md.moveString, md.comment);
+		emit moveChanged(plies - 1,
+				 m_board->genericMove(m_board->moveFromCompact(md.move)),
+				 m_lastMoveString, md.comment);
 	}
 
 	m_player[Chess::Side::White]->endGame(m_result);
@@ -439,10 +485,17 @@ void ChessGame::addPgnMove(const Chess::Move& move, const QString& comment)
 {
 	PgnGame::MoveData md;
 	md.key = m_board->key();
-	md.move = m_board->genericMove(move);
-	md.moveString = m_board->moveString(move, Chess::Board::StandardAlgebraic);
+	md.move = m_board->compactMove(move);
 	md.comment = comment;
 
+	// The PGN record doesn't keep move strings, so the last one is
+	// only generated for the moveMade() and moveChanged() receivers
+	if (hasMoveStringReceivers())
+		m_lastMoveString = m_board->moveString(move,
+			Chess::Board::StandardAlgebraic);
+	else
+		m_lastMoveString.clear();
+
 	m_board->makeMove(move);
 	m_pgn->addMove(md, m_board->key());
 	m_board->undoMove();
@@ -461,7 +514,18 @@ void ChessGame::emitLastMove()
 	}
 
 	const auto& md = m_pgn->moves().last();
-	emit moveMade(md.move, md.moveString, md.comment);
+	emit moveMade(m_board->genericMove(m_board->moveFromCompact(md.move)),
+		      m_lastMoveString, md.comment);
+}
+
+bool ChessGame::hasMoveStringReceivers() const
+{
+	static const QMetaMethod moveMadeSignal =
+		QMetaMethod::fromSignal(&ChessGame::moveMade);
+	static const QMetaMethod moveChangedSignal =
+		QMetaMethod::fromSignal(&ChessGame::moveChanged);
+	return isSignalConnected(moveMadeSignal)
+	    || isSignalConnected(moveChangedSignal);
 }
 
 void ChessGame::onMoveMade(const Chess::Move& move)
@@ -470,7 +534,7 @@ void ChessGame::onMoveMade(const Chess::Move& move)
 	Q_ASSERT(sender != nullptr);
 
 	Q_ASSERT(m_gameInProgress);
-	Q_ASSERT(m_board->isLegalMove(move));
+	Q_ASSERT(!move.isNull());
 	if (sender != playerToMove())
 	{
 		qWarning("%s tried to make a move on the opponent's turn",
@@ -478,12 +542,21 @@ void ChessGame::onMoveMade(const Chess::Move& move)
 		return;
 	}
 
+	// The move was already validated by the player that made it
+	qint64 cpuTime = threadCpuTime();
+
 	m_scores[m_moves.size()] = sender->evaluation().score();
 	m_moves.append(move);
 	addPgnMove(move, evalString(sender->evaluation(), move));
 
-	// Get the result before sending the move to the opponent
+	// The opponent needs the position before the move to
+	// convert it into a move string.
+	playerToWait()->makeMove(move);
+
+	// The legal moves of the new position decide whether the game
+	// is over, and they're kept to validate the opponent's reply
 	m_board->makeMove(move);
+	m_board->cacheLegalMoves();
 	m_result = m_board->result();
 	if (m_result.isNone())
 	{
@@ -493,11 +566,9 @@ void ChessGame::onMoveMade(const Chess::Move& move)
 		m_adjudicator.addEval(m_board, sender->evaluation());
 		m_result = m_adjudicator.result();
 	}
-	m_board->undoMove();
 
-	ChessPlayer* player = playerToWait();
-	player->makeMove(move);
-	m_board->makeMove(move);
+	m_moveCpuTime += threadCpuTime() - cpuTime;
+	m_moveCpuCount++;
 
 	if (m_result.isNone())
 	{
@@ -520,6 +591,7 @@ void ChessGame::startTurn()
 	Q_ASSERT(!side.isNull());
 
 	emit humanEnabled(m_player[side]->isHuman());
+	m_board->cacheLegalMoves();
 
 	Chess::Move move(bookMove(side));
 	if (move.isNull())
@@ -662,7 +734,7 @@ bool ChessGame::setMoves(const PgnGame& pgn)
 
 	for (const PgnGame::MoveData& md : pgn.moves())
 	{
-		Chess::Move move(m_board->moveFromGenericMove(md.move));
+		Chess::Move move(m_board->moveFromCompact(md.move));
 		if (!m_board->isLegalMove(move))
 			return false;
 
@@ -57,6 +57,12 @@ class LIB_EXPORT ChessGame : public QObject
 		const QVector<Chess::Move>& moves() const;
 		const QMap<int,int>& scores() const;
 		Chess::Result result() const;
+		/*!
+		 * Returns the average CPU time in nanoseconds that the game
+		 * spent applying and adjudicating one move, not counting
+		 * the time spent by the players.
+		 */
+		qint64 moveCpuTime() const;
 
 		void setError(const QString& message);
 		void setPlayer(Chess::Side side, ChessPlayer* player);
@@ -121,6 +127,7 @@ class LIB_EXPORT ChessGame : public QObject
 		void initializePgn();
 		void addPgnMove(const Chess::Move& move, const QString& comment);
 		void emitLastMove();
+		bool hasMoveStringReceivers() const;
 
 		QString evalString(const MoveEvaluation& eval, const Chess::Move& move);
 		QString statusString(const Chess::Move& move, bool doMove);
@@ -137,8 +144,11 @@ class LIB_EXPORT ChessGame : public QObject
 		bool m_pgnInitialized;
 		bool m_bookOwnership;
 		bool m_boardShouldBeFlipped;
+		qint64 m_moveCpuTime;
+		int m_moveCpuCount;
 		QString m_error;
 		QString m_startingFen;
+		QString m_lastMoveString;
 		Chess::Result m_result;
 		QVector<Chess::Move> m_moves;
 		QMap<int,int> m_scores;
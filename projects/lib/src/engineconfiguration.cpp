@@ -26,6 +26,7 @@ EngineConfiguration::EngineConfiguration()
 	  m_whiteEvalPov(false),
 	  m_pondering(false),
 	  m_validateClaims(true),
+	  m_incrementalPosition(false),
 	  m_restartMode(RestartAuto),
 	  m_rating(0)
 {
@@ -41,6 +42,7 @@ EngineConfiguration::EngineConfiguration(const QString& name,
 	  m_whiteEvalPov(false),
 	  m_pondering(false),
 	  m_validateClaims(true),
+	  m_incrementalPosition(false),
 	  m_restartMode(RestartAuto),
 	  m_rating(0)
 {
@@ -51,6 +53,7 @@ EngineConfiguration::EngineConfiguration(const QVariant& variant)
 	  m_whiteEvalPov(false),
 	  m_pondering(false),
 	  m_validateClaims(true),
+	  m_incrementalPosition(false),
 	  m_restartMode(RestartAuto),
 	  m_rating(0)
 {
@@ -82,6 +85,8 @@ EngineConfiguration::EngineConfiguration(const QVariant& variant)
 
 	if (map.contains("validateClaims"))
 		setClaimsValidated(map["validateClaims"].toBool());
+	if (map.contains("incrementalPosition"))
+		setIncrementalPosition(map["incrementalPosition"].toBool());
 
 	if (map.contains("variants"))
 		setSupportedVariants(map["variants"].toStringList());
@@ -114,6 +119,7 @@ EngineConfiguration::EngineConfiguration(const EngineConfiguration& other)
 	  m_whiteEvalPov(other.m_whiteEvalPov),
 	  m_pondering(other.m_pondering),
 	  m_validateClaims(other.m_validateClaims),
+	  m_incrementalPosition(other.m_incrementalPosition),
 	  m_restartMode(other.m_restartMode),
 	  m_rating(other.m_rating)
 {
@@ -140,6 +146,7 @@ EngineConfiguration& EngineConfiguration::operator=(EngineConfiguration&& other)
 	m_whiteEvalPov = other.m_whiteEvalPov;
 	m_pondering = other.m_pondering;
 	m_validateClaims = other.m_validateClaims;
+	m_incrementalPosition = other.m_incrementalPosition;
 	m_restartMode = other.m_restartMode;
 	m_options = other.m_options;
 	m_rating = other.m_rating;
@@ -178,6 +185,8 @@ QVariant EngineConfiguration::toVariant() const
 
 	if (!m_validateClaims)
 		map.insert("validateClaims", false);
+	if (m_incrementalPosition)
+		map.insert("incrementalPosition", true);
 
 	if (m_variants.count("standard") != m_variants.count())
 		map.insert("variants", m_variants);
@@ -384,6 +393,16 @@ void EngineConfiguration::setClaimsValidated(bool validate)
 	m_validateClaims = validate;
 }
 
+bool EngineConfiguration::incrementalPosition() const
+{
+	return m_incrementalPosition;
+}
+
+void EngineConfiguration::setIncrementalPosition(bool enabled)
+{
+	m_incrementalPosition = enabled;
+}
+
 EngineConfiguration& EngineConfiguration::operator=(const EngineConfiguration& other)
 {
 	if (this != &other)
@@ -399,6 +418,7 @@ EngineConfiguration& EngineConfiguration::operator=(const EngineConfiguration& o
 		m_whiteEvalPov = other.m_whiteEvalPov;
 		m_pondering = other.m_pondering;
 		m_validateClaims = other.m_validateClaims;
+		m_incrementalPosition = other.m_incrementalPosition;
 		m_restartMode = other.m_restartMode;
 		m_rating = other.m_rating;
 
@@ -433,6 +453,7 @@ bool EngineConfiguration::operator==(const EngineConfiguration& other) const
 	if (m_whiteEvalPov != other.m_whiteEvalPov
 		|| m_pondering != other.m_pondering
 		|| m_validateClaims != other.m_validateClaims
+		|| m_incrementalPosition != other.m_incrementalPosition
 		|| m_restartMode != other.m_restartMode
 		|| m_rating != other.m_rating
 		|| m_name != other.m_name
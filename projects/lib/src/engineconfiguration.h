@@ -217,6 +217,18 @@ class LIB_EXPORT EngineConfiguration
 		/*! Sets result claim validation mode to \a validate. */
 		void setClaimsValidated(bool validate);
 
+		/*!
+		 * Returns true if the engine accepts incremental position
+		 * updates; otherwise returns false.
+		 *
+		 * A UCI engine with incremental updates (off by default) is
+		 * only sent the new moves with "position moves ..." when
+		 * the previous position it was sent is still valid.
+		 */
+		bool incrementalPosition() const;
+		/*! Sets incremental position updates to \a enabled. */
+		void setIncrementalPosition(bool enabled);
+
 		/*!
 		 * Assigns \a other to this engine configuration and returns
 		 * a reference to this object.
@@ -239,6 +251,7 @@ class LIB_EXPORT EngineConfiguration
 		bool m_whiteEvalPov;
 		bool m_pondering;
 		bool m_validateClaims;
+		bool m_incrementalPosition;
 		RestartMode m_restartMode;
 		int m_rating;
 };
@@ -0,0 +1,497 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "engineprocess_linux.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVarLengthArray>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+// posix_spawn_file_actions_addchdir_np() was added in glibc 2.29
+#if defined(__GLIBC__) \
+ && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+  #define HAVE_SPAWN_ADDCHDIR
+#endif
+
+namespace {
+
+const int ReadChunkSize = 4096;
+
+class SigPipeIgnorer
+{
+	public:
+		SigPipeIgnorer()
+		{
+			// Writing to an engine that has exited must fail
+			// instead of killing the whole program
+			struct sigaction sa;
+			if (sigaction(SIGPIPE, nullptr, &sa) == 0
+			&&  sa.sa_handler == SIG_DFL)
+			{
+				sa.sa_handler = SIG_IGN;
+				sigaction(SIGPIPE, &sa, nullptr);
+			}
+		}
+};
+
+void closeFile(int* fd)
+{
+	if (*fd == -1)
+		return;
+	::close(*fd);
+	*fd = -1;
+}
+
+} // anonymous namespace
+
+EngineProcess::EngineProcess(QObject* parent)
+	: QIODevice(parent),
+	  m_started(false),
+	  m_pid(-1),
+	  m_exitCode(0),
+	  m_exitStatus(EngineProcess::NormalExit),
+	  m_stdErrFileMode(Truncate),
+	  m_inWrite(-1),
+	  m_outRead(-1),
+	  m_notifier(nullptr),
+	  m_exitTimer(new QTimer(this))
+{
+	m_exitTimer->setInterval(10);
+	connect(m_exitTimer, SIGNAL(timeout()), this, SLOT(onFinished()));
+}
+
+EngineProcess::~EngineProcess()
+{
+	if (m_started)
+	{
+		kill();
+		waitForFinished(-1);
+	}
+	cleanup();
+}
+
+int EngineProcess::exitCode() const
+{
+	return m_exitCode;
+}
+
+EngineProcess::ExitStatus EngineProcess::exitStatus() const
+{
+	return m_exitStatus;
+}
+
+qint64 EngineProcess::bytesAvailable() const
+{
+	return m_buffer.size() + QIODevice::bytesAvailable();
+}
+
+bool EngineProcess::canReadLine() const
+{
+	return m_buffer.contains('\n') || QIODevice::canReadLine();
+}
+
+void EngineProcess::cleanup()
+{
+	m_exitTimer->stop();
+	if (m_notifier != nullptr)
+	{
+		// The notifier may be the sender of the current signal
+		m_notifier->setEnabled(false);
+		m_notifier->deleteLater();
+		m_notifier = nullptr;
+	}
+
+	closeFile(&m_inWrite);
+	closeFile(&m_outRead);
+
+	m_pid = -1;
+	m_started = false;
+}
+
+void EngineProcess::close()
+{
+	if (!m_started && !isOpen())
+		return;
+
+	emit aboutToClose();
+	if (m_started)
+	{
+		kill();
+		waitForFinished(-1);
+	}
+	cleanup();
+	m_buffer.clear();
+	QIODevice::close();
+}
+
+bool EngineProcess::isSequential() const
+{
+	return true;
+}
+
+void EngineProcess::setWorkingDirectory(const QString& dir)
+{
+	m_workDir = dir;
+}
+
+void EngineProcess::setStandardErrorFile(const QString& fileName, OpenMode mode)
+{
+	m_stdErrFile = fileName;
+	m_stdErrFileMode = mode;
+}
+
+QStringList EngineProcess::splitCommand(const QString& command)
+{
+	QStringList args;
+	QString arg;
+	bool hasArg = false;
+	bool inQuote = false;
+
+	for (const QChar& c : command)
+	{
+		if (c == QLatin1Char('\"'))
+		{
+			inQuote = !inQuote;
+			hasArg = true;
+		}
+		else if (c.isSpace() && !inQuote)
+		{
+			if (hasArg)
+				args << arg;
+			arg.clear();
+			hasArg = false;
+		}
+		else
+		{
+			arg += c;
+			hasArg = true;
+		}
+	}
+	if (hasArg)
+		args << arg;
+
+	return args;
+}
+
+void EngineProcess::start(const QString& program,
+			  const QStringList& arguments,
+			  OpenMode mode)
+{
+	static const SigPipeIgnorer sigPipeIgnorer;
+	Q_UNUSED(sigPipeIgnorer);
+
+	if (m_started || isOpen())
+		close();
+
+	m_exitCode = 0;
+	m_exitStatus = NormalExit;
+
+	// Like QProcess, look for a program without a path in PATH
+	// first and then in the working directory. Resolving it here
+	// makes a missing program a start error, and it keeps the shell
+	// used without posix_spawn_file_actions_addchdir_np() from
+	// searching PATH only.
+	QString path(program);
+	if (!program.contains(QLatin1Char('/')))
+	{
+		const QString exe(QStandardPaths::findExecutable(program));
+		if (!exe.isEmpty())
+			path = exe;
+		else
+		{
+			const QFileInfo info(QDir(m_workDir), program);
+			if (!info.isFile() || !info.isExecutable())
+				return;
+			path = QLatin1String("./") + program;
+		}
+	}
+
+	int inPipe[2];
+	int outPipe[2];
+	if (pipe2(inPipe, O_CLOEXEC) == -1)
+		return;
+	if (pipe2(outPipe, O_CLOEXEC) == -1)
+	{
+		::close(inPipe[0]);
+		::close(inPipe[1]);
+		return;
+	}
+
+	// Only the parent's end of the output pipe is non-blocking
+	fcntl(outPipe[0], F_SETFL, fcntl(outPipe[0], F_GETFL) | O_NONBLOCK);
+
+	const QByteArray workDir(QFile::encodeName(m_workDir));
+	QList<QByteArray> args;
+#ifndef HAVE_SPAWN_ADDCHDIR
+	// Without posix_spawn_file_actions_addchdir_np() a shell has
+	// to change the directory before running the program
+	if (!workDir.isEmpty())
+		args << "/bin/sh" << "-c" << "cd -- \"$0\" && exec \"$@\""
+		     << workDir;
+#endif
+	args << QFile::encodeName(path);
+	for (const QString& arg : arguments)
+		args << QFile::encodeName(arg);
+
+	QVarLengthArray<char*, 16> argv;
+	for (QByteArray& arg : args)
+		argv.append(arg.data());
+	argv.append(nullptr);
+
+	// The child's copies of the pipes made by dup2() are not
+	// closed on exec, unlike all the other pipe ends
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, inPipe[0], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+
+	const QByteArray errFile(QFile::encodeName(m_stdErrFile));
+	if (errFile.isEmpty())
+		posix_spawn_file_actions_addopen(&actions, STDERR_FILENO,
+						 "/dev/null", O_WRONLY, 0);
+	else
+	{
+		const int flags = O_WRONLY | O_CREAT
+			| (m_stdErrFileMode.testFlag(Append) ? O_APPEND : O_TRUNC);
+		posix_spawn_file_actions_addopen(&actions, STDERR_FILENO,
+						 errFile.constData(), flags, 0666);
+	}
+#ifdef HAVE_SPAWN_ADDCHDIR
+	// Change the directory after opening the error file, whose
+	// path is relative to our working directory
+	if (!workDir.isEmpty())
+		posix_spawn_file_actions_addchdir_np(&actions,
+						     workDir.constData());
+#endif
+
+	// Don't let the engine inherit our signal mask or the ignored
+	// SIGPIPE signal
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+	sigset_t sigset;
+	sigemptyset(&sigset);
+	posix_spawnattr_setsigmask(&attr, &sigset);
+	sigaddset(&sigset, SIGPIPE);
+	posix_spawnattr_setsigdefault(&attr, &sigset);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK
+				      | POSIX_SPAWN_SETSIGDEF);
+
+	pid_t pid = -1;
+	int ret = posix_spawn(&pid, argv[0], &actions, &attr,
+			      argv.data(), environ);
+	posix_spawnattr_destroy(&attr);
+	posix_spawn_file_actions_destroy(&actions);
+
+	// Close the child process' ends of the pipes to make sure that
+	// reads return end-of-file when the child terminates
+	::close(inPipe[0]);
+	::close(outPipe[1]);
+
+	if (ret != 0)
+	{
+		::close(inPipe[1]);
+		::close(outPipe[0]);
+		return;
+	}
+
+	m_pid = pid;
+	m_inWrite = inPipe[1];
+	m_outRead = outPipe[0];
+	m_started = true;
+	m_buffer.clear();
+
+	// Start reading input from the child
+	m_notifier = new QSocketNotifier(m_outRead, QSocketNotifier::Read, this);
+	connect(m_notifier, SIGNAL(activated(int)), this, SLOT(onReadyRead()));
+
+	// Make QIODevice aware that the device is now open
+	QIODevice::open(mode);
+}
+
+void EngineProcess::start(const QString& program,
+			  OpenMode mode)
+{
+	QStringList args(splitCommand(program));
+	if (args.isEmpty())
+		return;
+
+	QString prog = args.first();
+	args.removeFirst();
+	start(prog, args, mode);
+}
+
+void EngineProcess::kill()
+{
+	if (m_started)
+		::kill(m_pid, SIGKILL);
+}
+
+void EngineProcess::onReadyRead()
+{
+	bool gotData = false;
+	for (;;)
+	{
+		const int size = m_buffer.size();
+		m_buffer.resize(size + ReadChunkSize);
+		const ssize_t n = ::read(m_outRead,
+					 m_buffer.data() + size,
+					 ReadChunkSize);
+		m_buffer.resize(size + int(qMax(n, ssize_t(0))));
+
+		if (n > 0)
+		{
+			gotData = true;
+			if (n < ReadChunkSize)
+				break;
+		}
+		else if (n == -1 && errno == EINTR)
+			continue;
+		else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		else
+		{
+			// End of file: the child closed its output, which
+			// normally means that it's exiting
+			m_notifier->setEnabled(false);
+			if (gotData)
+				emit readyRead();
+			emit readChannelFinished();
+
+			if (m_started)
+			{
+				m_exitTimer->start();
+				onFinished();
+			}
+			return;
+		}
+	}
+
+	if (gotData)
+		emit readyRead();
+}
+
+void EngineProcess::onFinished()
+{
+	if (!m_started)
+		return;
+
+	int status = 0;
+	pid_t ret = waitpid(m_pid, &status, WNOHANG);
+	if (ret == m_pid || (ret == -1 && errno == ECHILD))
+		finish(status);
+}
+
+void EngineProcess::finish(int status)
+{
+	m_exitStatus = NormalExit;
+	if (WIFEXITED(status))
+		m_exitCode = WEXITSTATUS(status);
+	else if (WIFSIGNALED(status))
+	{
+		m_exitCode = WTERMSIG(status);
+		m_exitStatus = CrashExit;
+	}
+
+	cleanup();
+	emit finished(m_exitCode, m_exitStatus);
+}
+
+bool EngineProcess::waitForFinished(int msecs)
+{
+	if (!m_started)
+		return true;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for (;;)
+	{
+		int status = 0;
+		pid_t ret = waitpid(m_pid, &status, msecs == -1 ? 0 : WNOHANG);
+		if (ret == m_pid || (ret == -1 && errno == ECHILD))
+		{
+			finish(status);
+			return true;
+		}
+		if (ret == -1 && errno == EINTR)
+			continue;
+		if (ret == -1 || (msecs != -1 && timer.elapsed() >= msecs))
+			return false;
+
+		QThread::msleep(1);
+	}
+}
+
+bool EngineProcess::waitForStarted(int msecs)
+{
+	// Don't wait here because posix_spawn already did the waiting
+	Q_UNUSED(msecs);
+	return m_started;
+}
+
+QString EngineProcess::workingDirectory() const
+{
+	return m_workDir;
+}
+
+qint64 EngineProcess::readData(char* data, qint64 maxSize)
+{
+	const int n = int(qMin(maxSize, qint64(m_buffer.size())));
+	if (n == 0)
+		return m_started ? 0 : -1;
+
+	memcpy(data, m_buffer.constData(), size_t(n));
+	m_buffer.remove(0, n);
+	return n;
+}
+
+qint64 EngineProcess::writeData(const char* data, qint64 maxSize)
+{
+	if (!m_started)
+		return -1;
+
+	qint64 written = 0;
+	while (written < maxSize)
+	{
+		const ssize_t n = ::write(m_inWrite,
+					  data + written,
+					  size_t(maxSize - written));
+		if (n == -1)
+		{
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		written += n;
+	}
+	return written;
+}
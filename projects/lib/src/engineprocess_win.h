@@ -33,7 +33,8 @@ class PipeReader;
  * new data immediately (no polling) when it's available. The interface is
  * the same as QProcess' with some unneeded features left out.
  *
- * On non-Windows platforms EngineProcess is just a typedef to QProcess.
+ * On Linux EngineProcess has its own implementation, and on other
+ * platforms it's just a typedef to QProcess.
  *
  * \sa QProcess
  * \sa PipeReader
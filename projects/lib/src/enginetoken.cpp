@@ -0,0 +1,155 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "enginetoken.h"
+#include <climits>
+#include <cstring>
+
+namespace {
+
+inline bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+} // anonymous namespace
+
+EngineToken::EngineToken()
+	: m_data(nullptr),
+	  m_size(0),
+	  m_end(nullptr)
+{
+}
+
+EngineToken::EngineToken(const char* data, int size, const char* end)
+	: m_data(data),
+	  m_size(size),
+	  m_end(end)
+{
+}
+
+EngineToken EngineToken::first(const char* line, int length, bool readToEnd)
+{
+	return EngineToken(line, 0, line + length).next(readToEnd);
+}
+
+EngineToken EngineToken::next(bool readToEnd) const
+{
+	if (m_data == nullptr)
+		return EngineToken();
+
+	const char* start = m_data + m_size;
+	while (start != m_end && isSpace(*start))
+		++start;
+	if (start == m_end)
+		return EngineToken();
+
+	const char* end = start;
+	if (readToEnd)
+	{
+		end = m_end;
+		while (isSpace(*(end - 1)))
+			--end;
+	}
+	else
+	{
+		while (end != m_end && !isSpace(*end))
+			++end;
+	}
+
+	return EngineToken(start, int(end - start), m_end);
+}
+
+EngineToken EngineToken::left(int n) const
+{
+	if (m_data == nullptr)
+		return EngineToken();
+	return EngineToken(m_data, qBound(0, n, m_size), m_end);
+}
+
+bool EngineToken::contains(char c) const
+{
+	return m_size > 0 && std::memchr(m_data, c, m_size) != nullptr;
+}
+
+bool EngineToken::operator==(const char* str) const
+{
+	if (m_data == nullptr)
+		return false;
+	return int(std::strlen(str)) == m_size
+	    && std::memcmp(m_data, str, m_size) == 0;
+}
+
+int EngineToken::toInt(bool* ok) const
+{
+	int i = 0;
+	bool negative = false;
+	if (m_size > 0 && (m_data[0] == '-' || m_data[0] == '+'))
+	{
+		negative = (m_data[0] == '-');
+		i++;
+	}
+
+	bool valid = (i < m_size);
+	qint64 value = 0;
+	for (; i < m_size && valid; i++)
+	{
+		char c = m_data[i];
+		if (!isDigit(c))
+			valid = false;
+		else if ((value = value * 10 + (c - '0')) > qint64(INT_MAX) + 1)
+			valid = false;
+	}
+	if (negative)
+		value = -value;
+	if (value > INT_MAX || value < INT_MIN)
+		valid = false;
+
+	if (ok != nullptr)
+		*ok = valid;
+	return valid ? int(value) : 0;
+}
+
+quint64 EngineToken::toULongLong(bool* ok) const
+{
+	bool valid = (m_size > 0);
+	quint64 value = 0;
+	for (int i = 0; i < m_size && valid; i++)
+	{
+		char c = m_data[i];
+		quint64 digit = quint64(c - '0');
+		if (!isDigit(c) || value > (ULLONG_MAX - digit) / 10)
+			valid = false;
+		else
+			value = value * 10 + digit;
+	}
+
+	if (ok != nullptr)
+		*ok = valid;
+	return valid ? value : 0;
+}
+
+QString EngineToken::toString() const
+{
+	if (m_data == nullptr)
+		return QString();
+	return QString::fromUtf8(m_data, m_size);
+}
@@ -0,0 +1,128 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ENGINETOKEN_H
+#define ENGINETOKEN_H
+
+#include <QString>
+
+/*!
+ * \brief A whitespace-delimited token in a line of engine output
+ *
+ * EngineToken refers to the bytes of a line that was read from a
+ * chess engine without copying them, so the line must outlive its
+ * tokens. Tokens are read with first() and next() the same way
+ * ChessEngine::firstToken() and ChessEngine::nextToken() read
+ * QStringRefs, numbers are parsed in place, and a QString is only
+ * created for tokens that are converted with toString().
+ */
+class LIB_EXPORT EngineToken
+{
+	public:
+		/*! Creates a new null token. */
+		EngineToken();
+
+		/*!
+		 * Returns the first token of \a line, which is \a length
+		 * bytes long.
+		 *
+		 * If \a readToEnd is true, the whole line is read, except
+		 * for leading and trailing whitespace. If the line doesn't
+		 * contain any words, a null token is returned.
+		 */
+		static EngineToken first(const char* line,
+					 int length,
+					 bool readToEnd = false);
+		/*!
+		 * Returns the token that follows this one on the line.
+		 *
+		 * If \a readToEnd is true, everything from the next word
+		 * to the end of the line is read, except for trailing
+		 * whitespace. If there are no more words, a null token is
+		 * returned.
+		 */
+		EngineToken next(bool readToEnd = false) const;
+
+		/*! Returns true if this is a null token. */
+		bool isNull() const;
+		/*! Returns the token's size in bytes. */
+		int size() const;
+		/*! Returns a pointer to the token's first byte. */
+		const char* data() const;
+		/*! Returns the byte at position \a i. */
+		char at(int i) const;
+		/*! Returns the first \a n bytes of the token. */
+		EngineToken left(int n) const;
+		/*! Returns true if the token contains byte \a c. */
+		bool contains(char c) const;
+
+		/*! Returns true if the token is equal to \a str. */
+		bool operator==(const char* str) const;
+		/*! Returns true if the token is not equal to \a str. */
+		bool operator!=(const char* str) const;
+
+		/*!
+		 * Returns the token as a decimal integer.
+		 *
+		 * If \a ok is not null, it is set to false if the token
+		 * isn't a valid integer.
+		 */
+		int toInt(bool* ok = nullptr) const;
+		/*!
+		 * Returns the token as an unsigned decimal integer.
+		 *
+		 * If \a ok is not null, it is set to false if the token
+		 * isn't a valid unsigned integer.
+		 */
+		quint64 toULongLong(bool* ok = nullptr) const;
+		/*! Returns the token as a UTF-8 decoded QString. */
+		QString toString() const;
+
+	private:
+		EngineToken(const char* data, int size, const char* end);
+
+		const char* m_data;
+		int m_size;
+		const char* m_end;
+};
+
+inline bool EngineToken::isNull() const
+{
+	return m_data == nullptr;
+}
+
+inline int EngineToken::size() const
+{
+	return m_size;
+}
+
+inline const char* EngineToken::data() const
+{
+	return m_data;
+}
+
+inline char EngineToken::at(int i) const
+{
+	Q_ASSERT(i >= 0 && i < m_size);
+	return m_data[i];
+}
+
+inline bool EngineToken::operator!=(const char* str) const
+{
+	return !(*this == str);
+}
+
+#endif // ENGINETOKEN_H
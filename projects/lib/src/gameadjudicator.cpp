@@ -28,6 +28,8 @@ GameAdjudicator::GameAdjudicator()
 	  m_resignScore(0),
 	  m_maxGameLength(0),
 	  m_tbEnabled(false),
+	  m_tbWdlOnly(false),
+	  m_tbMaterialKey(0),
 	  m_tcecAdjudication(false)
 {
 	m_resignScoreCount[0] = 0;
@@ -70,6 +72,12 @@ void GameAdjudicator::setTablebaseAdjudication(bool enable)
 	m_tbEnabled = enable;
 }
 
+void GameAdjudicator::setTablebaseWdlAdjudication(bool enable)
+{
+	m_tbWdlOnly = enable;
+	m_tbMaterialKey = 0;
+}
+
 void GameAdjudicator::setTcecAdjudication(bool enable)
 {
 	m_tcecAdjudication = enable;
@@ -80,12 +88,23 @@ void GameAdjudicator::addEval(const Chess::Board* board, const MoveEvaluation& e
 	Chess::Side side = board->sideToMove().opposite();
 
 	// Tablebase adjudication
-	if (m_tbEnabled)
+	if (m_tbEnabled && !m_tbWdlOnly)
 	{
 		m_result = board->tablebaseResult();
 		if (!m_result.isNone())
 			return;
 	}
+	// A game is adjudicated as soon as it enters the tablebases, so
+	// there's no need to probe again until the material changes. Right
+	// after a capture or promotion the fifty-move counter is zero,
+	// which makes a WDL probe exact.
+	else if (m_tbEnabled && board->materialKey() != m_tbMaterialKey)
+	{
+		m_tbMaterialKey = board->materialKey();
+		m_result = board->tablebaseWdlResult();
+		if (!m_result.isNone())
+			return;
+	}
 
 	// Moves forced by the user (eg. from opening book or played by user)
 	if (eval.depth() <= 0)
@@ -71,6 +71,14 @@ class LIB_EXPORT GameAdjudicator
 		 * latest position is found in the tablebases.
 		 */
 		void setTablebaseAdjudication(bool enable);
+		/*!
+		 * Sets WDL-only tablebase adjudication to \a enable.
+		 *
+		 * If \a enable is true then tablebase adjudication only probes
+		 * the win/draw/loss tables, and only when the material on the
+		 * board changes. Results are cached across games.
+		 */
+		void setTablebaseWdlAdjudication(bool enable);
 		/*!
 		 * Sets TCEC adjudication to \a enable.
 		 *
@@ -117,6 +125,8 @@ class LIB_EXPORT GameAdjudicator
 		int m_resignScoreCount[2];
 		int m_maxGameLength;
 		bool m_tbEnabled;
+		bool m_tbWdlOnly;
+		quint64 m_tbMaterialKey;
 		Chess::Result m_result;
 		int m_resignWinnerScoreCount[2];
 		bool m_tcecAdjudication;
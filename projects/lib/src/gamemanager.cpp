@@ -17,6 +17,7 @@
 
 #include "gamemanager.h"
 #include <QThread>
+#include <QMetaMethod>
 #include <algorithm>
 #include "playerbuilder.h"
 #include "chessgame.h"
@@ -137,8 +138,11 @@ void GameInitializer::initializeGame()
 		if (m_player[i] == nullptr)
 		{
 			QString error;
-			m_player[i] = m_builder[i]->create(thread()->parent(),
-							   SIGNAL(debugMessage(QString)),
+			auto manager = qobject_cast<GameManager*>(thread()->parent());
+			const char* method = nullptr;
+			if (manager != nullptr && manager->isDebugMessageConnected())
+				method = SIGNAL(debugMessage(QString));
+			m_player[i] = m_builder[i]->create(manager, method,
 							   this, &error);
 			m_game->setError(error);
 
@@ -352,6 +356,13 @@ void GameManager::setConcurrency(int concurrency)
 	m_concurrency = concurrency;
 }
 
+bool GameManager::isDebugMessageConnected() const
+{
+	static const QMetaMethod debugSignal =
+		QMetaMethod::fromSignal(&GameManager::debugMessage);
+	return isSignalConnected(debugSignal);
+}
+
 void GameManager::cleanupIdleThreads()
 {
 	QList<GameThread*>::iterator it = m_activeThreads.begin();
@@ -96,6 +96,14 @@ class LIB_EXPORT GameManager : public QObject
 		 * \sa concurrency()
 		 */
 		void setConcurrency(int concurrency);
+		/*!
+		 * Returns true if the debugMessage() signal is connected.
+		 *
+		 * New players only send their debug messages to the game
+		 * manager if it is, so that their input and output isn't
+		 * traced for nothing.
+		 */
+		bool isDebugMessageConnected() const;
 
 		/*!
 		 * Cleans up and deletes all idle game threads
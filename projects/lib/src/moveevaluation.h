@@ -117,6 +117,11 @@ class LIB_EXPORT MoveEvaluation
 		 * The principal variation.
 		 * This is a sequence of moves that an engine
 		 * expects to be played next.
+		 *
+		 * The moves are in the notation the engine sent them in,
+		 * eg. coordinate notation for UCI engines, unless the
+		 * evaluation was prepared for live display.
+		 * \sa Chess::Board::sanStringForPv()
 		 * \note For human players this is always empty.
 		 */
 		QString pv() const;
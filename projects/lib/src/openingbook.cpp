@@ -24,6 +24,13 @@
 #include "pgnstream.h"
 #include "mersenne.h"
 
+namespace {
+
+// Book moves are stored in memory as compact 8x8 moves
+const int BookWidth = 8;
+const int BookHeight = 8;
+
+} // anonymous namespace
 
 QDataStream& operator>>(QDataStream& in, OpeningBook* book)
 {
@@ -91,13 +98,25 @@ bool OpeningBook::write(const QString& filename) const
 	return true;
 }
 
+OpeningBook::Entry OpeningBook::unpackEntry(const CompactEntry& entry)
+{
+	return { Chess::GenericMove::fromCompact(entry.move,
+						 BookWidth,
+						 BookHeight),
+		 entry.weight };
+}
+
 void OpeningBook::addEntry(const Entry& entry, quint64 key)
 {
+	quint16 move = entry.move.toCompact(BookWidth, BookHeight);
+	if (move == 0)
+		return;
+
 	Map::iterator it = m_map.find(key);
 	while (it != m_map.end() && it.key() == key)
 	{
-		Entry& tmp = it.value();
-		if (tmp.move == entry.move)
+		CompactEntry& tmp = it.value();
+		if (tmp.move == move)
 		{
 			tmp.weight += entry.weight;
 			return;
@@ -105,7 +124,7 @@ void OpeningBook::addEntry(const Entry& entry, quint64 key)
 		++it;
 	}
 	
-	m_map.insert(key, entry);
+	m_map.insert(key, { move, entry.weight });
 }
 
 int OpeningBook::import(const PgnGame& pgn, int maxMoves)
@@ -131,7 +150,7 @@ int OpeningBook::import(const PgnGame& pgn, int maxMoves)
 		// Skip the loser's moves
 		if ((i % 2) != loserMod)
 		{
-			Entry entry = { moves.at(i).move, weight };
+			Entry entry = { pgn.genericMove(i), weight };
 			addEntry(entry, moves.at(i).key);
 		}
 	}
@@ -219,9 +238,18 @@ QList<OpeningBook::Entry> OpeningBook::entriesFromDisk(quint64 key) const
 
 QList<OpeningBook::Entry> OpeningBook::entries(quint64 key) const
 {
-	if (m_mode == Ram)
-		return m_map.values(key);
-	return entriesFromDisk(key);
+	if (m_mode != Ram)
+		return entriesFromDisk(key);
+
+	QList<Entry> entries;
+	Map::const_iterator it = m_map.constFind(key);
+	while (it != m_map.constEnd() && it.key() == key)
+	{
+		entries << unpackEntry(it.value());
+		++it;
+	}
+
+	return entries;
 }
 
 Chess::GenericMove OpeningBook::move(quint64 key) const
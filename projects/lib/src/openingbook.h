@@ -127,13 +127,35 @@ class LIB_EXPORT OpeningBook
 		friend LIB_EXPORT QDataStream& operator>>(QDataStream& in, OpeningBook* book);
 		friend LIB_EXPORT QDataStream& operator<<(QDataStream& out, const OpeningBook* book);
 
+		/*!
+		 * \brief An entry as it is kept in memory.
+		 *
+		 * The move is encoded by Chess::GenericMove::toCompact()
+		 * for an 8x8 board, so that large books stay small in RAM.
+		 */
+		struct CompactEntry
+		{
+			/*! The compact book move. */
+			quint16 move;
+			/*! The weight of the move. */
+			quint16 weight;
+		};
+
 		/*! The type of binary tree. */
-		typedef QMultiMap<quint64, Entry> Map;
+		typedef QMultiMap<quint64, CompactEntry> Map;
+
+		/*! Converts a compact in-memory entry into an Entry. */
+		static Entry unpackEntry(const CompactEntry& entry);
 
 		/*! Returns the book format's internal entry size in bytes. */
 		virtual int entrySize() const = 0;
 
-		/*! Adds a new entry to the book. */
+		/*!
+		 * Adds a new entry to the book.
+		 *
+		 * Entries whose move can't be encoded for an 8x8 board
+		 * are ignored.
+		 */
 		void addEntry(const Entry& entry, quint64 key);
 		
 		/*!
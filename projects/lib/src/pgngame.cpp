@@ -52,7 +52,9 @@ QTextStream& operator<<(QTextStream& out, const PgnGame& game)
 PgnGame::PgnGame()
 	: m_startingSide(Chess::Side::White),
 	  m_tagReceiver(nullptr),
-	  m_key(0)
+	  m_key(0),
+	  m_boardWidth(0),
+	  m_boardHeight(0)
 {
 }
 
@@ -120,6 +122,54 @@ void PgnGame::setMove(int ply, const MoveData& data)
 	m_moves[ply] = data;
 }
 
+void PgnGame::updateBoardSize() const
+{
+	// The board size only depends on the variant
+	const QString variant(this->variant());
+	if (variant == m_sizeVariant)
+		return;
+
+	Chess::Board* board = Chess::BoardFactory::create(variant);
+	m_boardWidth = board ? board->width() : 0;
+	m_boardHeight = board ? board->height() : 0;
+	m_sizeVariant = variant;
+	delete board;
+}
+
+Chess::GenericMove PgnGame::genericMove(int ply) const
+{
+	updateBoardSize();
+	return Chess::GenericMove::fromCompact(m_moves.at(ply).move,
+					       m_boardWidth, m_boardHeight);
+}
+
+QStringList PgnGame::moveStrings() const
+{
+	Chess::Board* board = createBoard();
+	if (board == nullptr)
+		return QStringList();
+
+	QVector<Chess::Move> moves;
+	moves.reserve(m_moves.size());
+	for (const MoveData& md : m_moves)
+	{
+		Chess::Move move(board->moveFromCompact(md.move));
+		if (move.isNull())
+			break;
+		moves.append(move);
+	}
+
+	// The whole game is converted in one go so that the legal
+	// moves of each position are generated only once
+	QStringList strings;
+	if (!moves.isEmpty())
+		strings = board->moveSequenceString(moves,
+			Chess::Board::StandardAlgebraic).split(QLatin1Char(' '));
+	delete board;
+
+	return strings;
+}
+
 Chess::Board* PgnGame::createBoard() const
 {
 	Chess::Board* board = Chess::BoardFactory::create(variant());
@@ -191,16 +241,23 @@ bool PgnGame::parseMove(PgnStream& in, bool addEco)
 		m_startingSide = board->startingSide();
 	}
 
-	const QString str(in.tokenString());
-	Chess::Move move(board->moveFromString(str));
+	const QByteArray token(in.tokenString());
+	Chess::Move move(board->moveFromString(token.constData(), token.size()));
 	if (move.isNull())
 	{
-		qWarning("Illegal move: %s", qUtf8Printable(str));
+		qWarning("Illegal move: %s", token.constData());
 		return false;
 	}
 
-	MoveData md = { board->key(), board->genericMove(move),
-			str, QString() };
+	// Remember the board size for decoding the moves later
+	if (m_moves.isEmpty())
+	{
+		m_sizeVariant = variant();
+		m_boardWidth = board->width();
+		m_boardHeight = board->height();
+	}
+
+	MoveData md = { board->key(), board->compactMove(move), QString() };
 	board->makeMove(move);
 	addMove(md, board->key(), addEco);
 
@@ -271,6 +328,13 @@ bool PgnGame::write(QTextStream& out, PgnMode mode) const
 {
 	if (m_tags.isEmpty())
 		return false;
+
+	const QStringList sanMoves(moveStrings());
+	if (sanMoves.size() != m_moves.size())
+	{
+		qWarning("Cannot convert the moves of the game to SAN");
+		return false;
+	}
 	
 	const QList< QPair<QString, QString> > tags = this->tags();
 	int maxTags = (mode == Verbose) ? tags.size() : 7;
@@ -307,7 +371,7 @@ bool PgnGame::write(QTextStream& out, PgnMode mode) const
 		else if (side == Chess::Side::White)
 			str = QString::number(++movenum) + ". ";
 
-		str += data.moveString;
+		str += sanMoves.at(i);
 		if (mode == Verbose && !data.comment.isEmpty())
 			str += QString(" {%1}").arg(data.comment);
 
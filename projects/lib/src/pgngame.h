@@ -20,6 +20,7 @@
 
 #include <QMap>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 #include <QList>
 #include <QPair>
@@ -60,15 +61,19 @@ class LIB_EXPORT PgnGame
 			Verbose
 		};
 
-		/*! \brief A struct for storing the game's move history. */
+		/*!
+		 * \brief A struct for storing the game's move history.
+		 *
+		 * Moves are stored in 16 bits and without their SAN strings,
+		 * which are generated from the moves when they're needed.
+		 * \sa genericMove(), moveStrings()
+		 */
 		struct MoveData
 		{
 			/*! The zobrist position key before the move. */
 			quint64 key;
-			/*! The move in the "generic" format. */
-			Chess::GenericMove move;
-			/*! The move in Standard Algebraic Notation. */
-			QString moveString;
+			/*! The move encoded by Chess::Board::compactMove(). */
+			quint16 move;
 			/*! A comment/annotation describing the move. */
 			QString comment;
 		};
@@ -91,6 +96,16 @@ class LIB_EXPORT PgnGame
 		 */
 		void addMove(const MoveData& data, quint64 key, bool addEco = true);
 		void setMove(int ply, const MoveData& data);
+		/*! Returns the move at \a ply in the "generic" format. */
+		Chess::GenericMove genericMove(int ply) const;
+		/*!
+		 * Returns the game's moves in Standard Algebraic Notation.
+		 *
+		 * The strings are generated by playing the moves on a board
+		 * created with createBoard(). Returns an empty list if the
+		 * board can't be created.
+		 */
+		QStringList moveStrings() const;
 
 		/*!
 		 * Creates a board object for viewing or analyzing the game.
@@ -217,6 +232,7 @@ class LIB_EXPORT PgnGame
 
 	private:
 		bool parseMove(PgnStream& in, bool addEco);
+		void updateBoardSize() const;
 		
 		Chess::Side m_startingSide;
 		QMap<QString, QString> m_tags;
@@ -227,6 +243,9 @@ class LIB_EXPORT PgnGame
 		QDateTime m_gameStartTime;
 		QTime m_gameDuration;
 		quint64 m_key;
+		mutable QString m_sizeVariant;
+		mutable int m_boardWidth;
+		mutable int m_boardHeight;
 };
 
 /*! Reads a PGN game from a PGN stream. */
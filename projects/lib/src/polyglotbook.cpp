@@ -81,8 +81,9 @@ void PolyglotBook::writeEntry(const Map::const_iterator& it,
 {
 	quint32 learn = 0;
 	quint64 key = it.key();
-	quint16 pgMove = moveToBits(it.value().move);
-	quint16 weight = it.value().weight;
+	const Entry entry = unpackEntry(it.value());
+	quint16 pgMove = moveToBits(entry.move);
+	quint16 weight = entry.weight;
 	
 	// Store the data. Again, big-endian is used by default.
 	out << key << pgMove << weight << learn;
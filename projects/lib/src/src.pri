@@ -4,6 +4,7 @@ DEPENDPATH += $$PWD
 HEADERS += $$PWD/chessengine.h \
     $$PWD/chessgame.h \
     $$PWD/chessplayer.h \
+    $$PWD/enginetoken.h \
     $$PWD/engineconfiguration.h \
     $$PWD/openingbook.h \
     $$PWD/pgnstream.h \
@@ -48,6 +49,7 @@ HEADERS += $$PWD/chessengine.h \
 SOURCES += $$PWD/chessengine.cpp \
     $$PWD/chessgame.cpp \
     $$PWD/chessplayer.cpp \
+    $$PWD/enginetoken.cpp \
     $$PWD/engineconfiguration.cpp \
     $$PWD/openingbook.cpp \
     $$PWD/pgnstream.cpp \
@@ -94,3 +96,7 @@ win32 {
     SOURCES += $$PWD/engineprocess_win.cpp \
 	$$PWD/pipereader_win.cpp
 }
+linux {
+    HEADERS += $$PWD/engineprocess_linux.h
+    SOURCES += $$PWD/engineprocess_linux.cpp
+}
@@ -638,8 +638,12 @@ bool Tournament::writeEpd(ChessGame *game)
 		m_epdOut.setDevice(&m_epdFile);
 	}
 
-	const QString& epdPos = game->board()->fenString();
-	m_epdOut << epdPos << "\n";
+	char epdPos[512];
+	int length = game->board()->fenString(epdPos, sizeof(epdPos));
+	if (length >= 0)
+		m_epdOut << QLatin1String(epdPos, length) << "\n";
+	else
+		m_epdOut << game->board()->fenString() << "\n";
 	m_epdOut.flush();
 	bool ok = true;
 	if (m_epdFile.error() != QFile::NoError)
@@ -740,20 +744,24 @@ void Tournament::onPgnMove()
 
 		// Parse and assemble move stats
 		const QVector<PgnGame::MoveData>& moves = pgn->moves();
+		const QStringList moveStrings(pgn->moveStrings());
 		QVariantList mList;
-		for (const PgnGame::MoveData& move : moves)
+		for (int i = 0; i < moves.size(); i++)
 		{
+			const PgnGame::MoveData& move = moves.at(i);
+			const Chess::GenericMove gmove(
+				board->genericMove(board->moveFromCompact(move.move)));
 			QVariantMap mMap;
 			QVariantMap aMap;
 
-			mMap["m"] = move.moveString;
+			mMap["m"] = moveStrings.value(i);
 
-			QString sq(static_cast<char>(move.move.sourceSquare().file() + 'a'));
-			sq += static_cast<char>(move.move.sourceSquare().rank() + '1');
+			QString sq(static_cast<char>(gmove.sourceSquare().file() + 'a'));
+			sq += static_cast<char>(gmove.sourceSquare().rank() + '1');
 			mMap["from"] = sq;
 
-			sq = static_cast<char>(move.move.targetSquare().file() + 'a');
-			sq += static_cast<char>(move.move.targetSquare().rank() + '1');
+			sq = static_cast<char>(gmove.targetSquare().file() + 'a');
+			sq += static_cast<char>(gmove.targetSquare().rank() + '1');
 			mMap["to"] = sq;
 
 			mMap["book"] = false;
@@ -837,7 +845,7 @@ void Tournament::onPgnMove()
 			if (!aMap.empty())
 				mMap["adjudication"] = aMap;
 
-			board->makeMove(board->moveFromGenericMove(move.move));
+			board->makeMove(board->moveFromCompact(move.move));
 
 			mMap["fen"] = board->fenString();
 
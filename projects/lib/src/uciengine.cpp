@@ -19,6 +19,7 @@
 
 #include <QString>
 #include <QStringList>
+#include <QMetaMethod>
 
 #include "board/board.h"
 #include "board/boardfactory.h"
@@ -84,6 +85,8 @@ QStringRef joinTokens(const QVarLengthArray<QStringRef>& tokens)
 
 UciEngine::UciEngine(QObject* parent)
 	: ChessEngine(parent),
+	  m_positionBase(0),
+	  m_positionSent(0),
 	  m_sendOpponentsName(false),
 	  m_canPonder(false),
 	  m_ponderState(NotPondering),
@@ -102,24 +105,53 @@ void UciEngine::startProtocol()
 	write("uci");
 }
 
-QString UciEngine::positionString()
+QByteArray UciEngine::positionCommand()
 {
-	QString str("position");
-
-	if (board()->isRandomVariant() || m_startFen != board()->defaultFenString())
-		str += QString(" fen ") + m_startFen;
-	else
-		str += " startpos";
+	// Engines that accept incremental updates are only sent the
+	// moves that were made after the last position they got
+	if (incrementalPosition()
+	&&  m_positionSent > 0
+	&&  m_positionSent < m_position.size())
+	{
+		QByteArray command("position");
+		if (m_positionSent > m_positionBase)
+			command += " moves";
+		command += m_position.mid(m_positionSent);
+		m_positionSent = m_position.size();
+		return command;
+	}
+
+	m_positionSent = m_position.size();
+	return m_position;
+}
 
-	if (!m_moveStrings.isEmpty())
-		str += QString(" moves") + m_moveStrings;
+void UciEngine::sendPosition()
+{
+	const QByteArray command(positionCommand());
+	writeLine(command.constData(), command.size());
+}
 
-	return str;
+void UciEngine::addPositionMove(const QString& moveString)
+{
+	if (m_position.size() == m_positionBase)
+		m_position += " moves";
+	m_position += ' ';
+	m_position += moveString.toLatin1();
 }
 
-void UciEngine::sendPosition()
+void UciEngine::removePositionMove()
 {
-	write(positionString());
+	if (m_position.size() == m_positionBase)
+		return;
+
+	// Drop the " moves" token with the only move
+	int length = m_position.lastIndexOf(' ');
+	if (length == m_positionBase + 6)
+		length = m_positionBase;
+
+	m_position.truncate(length);
+	if (m_positionSent > length)
+		m_positionSent = 0;
 }
 
 void UciEngine::startGame()
@@ -135,13 +167,30 @@ void UciEngine::startGame()
 	m_movesPondered = 0;
 	m_ponderHits = 0;
 	m_bmBuffer.clear();
-	m_moveStrings.clear();
 	m_useDirectPv = directPvList.contains(board()->variant());
 
+	// Keep the buffer's capacity from the previous game
+	m_position.reserve(4096);
+	m_position.resize(0);
+	m_position += "position";
 	if (board()->isRandomVariant())
-		m_startFen = board()->fenString(Chess::Board::ShredderFen);
+	{
+		m_position += " fen ";
+		m_position += board()->fenString(Chess::Board::ShredderFen).toLatin1();
+	}
 	else
-		m_startFen = board()->fenString(Chess::Board::XFen);
+	{
+		const QString fen(board()->fenString(Chess::Board::XFen));
+		if (fen != board()->defaultFenString())
+		{
+			m_position += " fen ";
+			m_position += fen.toLatin1();
+		}
+		else
+			m_position += " startpos";
+	}
+	m_positionBase = m_position.size();
+	m_positionSent = 0;
 	setVariant(board()->variant());
 
 	write("ucinewgame");
@@ -186,7 +235,7 @@ void UciEngine::makeMove(const Chess::Move& move)
 			m_ponderMoveSan.clear();
 			if (m_ponderState != PonderHit)
 			{
-				m_moveStrings.truncate(m_moveStrings.lastIndexOf(' '));
+				removePositionMove();
 				if (isReady())
 				{
 					m_ignoreThinking = true;
@@ -206,9 +255,9 @@ void UciEngine::makeMove(const Chess::Move& move)
 	if (m_ponderState != PonderHit)
 	{
 		m_ponderState = NotPondering;
-		m_moveStrings += " " + board()->moveString(move, Chess::Board::LongAlgebraic);
+		addPositionMove(board()->moveString(move, Chess::Board::LongAlgebraic));
 		if (m_ignoreThinking)
-			m_bmBuffer << positionString() << "isready";
+			m_bmBuffer << positionCommand() << QByteArray("isready");
 		else
 			sendPosition();
 	}
@@ -287,7 +336,7 @@ void UciEngine::startPondering()
 	if (!pondering() || m_ponderMove.isNull())
 		return;
 
-	m_moveStrings += " " + board()->moveString(m_ponderMove, Chess::Board::LongAlgebraic);
+	addPositionMove(board()->moveString(m_ponderMove, Chess::Board::LongAlgebraic));
 	sendPosition();
 	ping();
 	startThinking();
@@ -358,7 +407,39 @@ QStringRef UciEngine::parseUciTokens(const QStringRef& first,
 	return token;
 }
 
-void UciEngine::parseInfo(const QVarLengthArray<QStringRef>& tokens,
+EngineToken UciEngine::parseUciTokens(const EngineToken& first,
+				      const char* const* types,
+				      int typeCount,
+				      QVarLengthArray<EngineToken>& tokens,
+				      int& type)
+{
+	EngineToken token(first);
+	type = -1;
+	tokens.clear();
+
+	do
+	{
+		bool newType = false;
+		for (int i = 0; i < typeCount; i++)
+		{
+			if (token == types[i])
+			{
+				if (type != -1)
+					return token;
+				type = i;
+				newType = true;
+				break;
+			}
+		}
+		if (!newType && type != -1)
+			tokens.append(token);
+	}
+	while (!(token = token.next()).isNull());
+
+	return token;
+}
+
+void UciEngine::parseInfo(const QVarLengthArray<EngineToken>& tokens,
 			  int type,
 			  MoveEvaluation* eval)
 {
@@ -388,22 +469,22 @@ void UciEngine::parseInfo(const QVarLengthArray<QStringRef>& tokens,
 	switch (type)
 	{
 	case InfoDepth:
-		eval->setDepth(tokens[0].toString().toInt());
+		eval->setDepth(tokens[0].toInt());
 		break;
 	case InfoSelDepth:
-		eval->setSelectiveDepth(tokens[0].toString().toInt());
+		eval->setSelectiveDepth(tokens[0].toInt());
 		break;
 	case InfoTime:
-		eval->setTime(tokens[0].toString().toInt());
+		eval->setTime(tokens[0].toInt());
 		break;
 	case InfoNodes:
-		eval->setNodeCount(tokens[0].toString().toULongLong());
+		eval->setNodeCount(tokens[0].toULongLong());
 		break;
 	case InfoMultiPv:
-		eval->setPvNumber(tokens[0].toString().toInt());
+		eval->setPvNumber(tokens[0].toInt());
 		break;
 	case InfoPv:
-		eval->setPv(m_useDirectPv ?  directPv(tokens) : sanPv(tokens));
+		eval->setPv(m_useDirectPv ?  directPv(tokens) : coordinatePv(tokens));
 		break;
 	case InfoScore:
 		{
@@ -411,10 +492,10 @@ void UciEngine::parseInfo(const QVarLengthArray<QStringRef>& tokens,
 			for (int i = 1; i < tokens.size(); i++)
 			{
 				if (tokens[i - 1] == "cp")
-					score = tokens[i].toString().toInt();
+					score = tokens[i].toInt();
 				else if (tokens[i - 1] == "mate")
 				{
-					score = tokens[i].toString().toInt();
+					score = tokens[i].toInt();
 					if (score > 0)
 						score = 99000 + 1 - score * 2;
 					else if (score < 0)
@@ -431,19 +512,19 @@ void UciEngine::parseInfo(const QVarLengthArray<QStringRef>& tokens,
 		}
 		break;
 	case InfoTbHits:
-		eval->setTbHits(tokens[0].toString().toULongLong());
+		eval->setTbHits(tokens[0].toULongLong());
 		break;
 	case InfoHashFull:
-		eval->setHashUsage(tokens[0].toString().toInt());
+		eval->setHashUsage(tokens[0].toInt());
 		break;
 	default:
 		break;
 	}
 }
 
-void UciEngine::parseInfo(const QStringRef& line)
+void UciEngine::parseInfo(const EngineToken& command)
 {
-	static const QString types[] =
+	static const char* const types[] =
 	{
 		"depth",
 		"seldepth",
@@ -464,8 +545,8 @@ void UciEngine::parseInfo(const QStringRef& line)
 	};
 
 	int type = -1;
-	QStringRef token(nextToken(line));
-	QVarLengthArray<QStringRef> tokens;
+	EngineToken token(command.next());
+	QVarLengthArray<EngineToken> tokens;
 	MoveEvaluation eval;
 
 	// The "string" info is not supported and it can't be parsed
@@ -486,10 +567,20 @@ void UciEngine::parseInfo(const QStringRef& line)
 	if (m_movesPondered)
 		eval.setPonderhitRate((m_ponderHits * 1000) / m_movesPondered);
 
+	// The game's evaluation keeps the coordinate PV. ChessGame
+	// converts it to SAN once, when the move is added to the PGN
+	bool primary = eval.pvNumber() <= 1;
+	if (primary)
+		m_eval.merge(eval);
+
+	// Convert the PV to SAN only if someone, eg. the GUI's
+	// evaluation widget, is showing the engine's thinking
+	if (!m_useDirectPv && !eval.pv().isEmpty() && hasLiveEvalReceivers())
+		eval.setPv(sanPv(eval.pv()));
+
 	// Only the primary PV can be considered the current eval
-	if (eval.pvNumber() <= 1)
+	if (primary)
 	{
-		m_eval.merge(eval);
 		if (eval.depth() && eval.depth() != m_currentEval.depth())
 			m_currentEval.clear();
 		m_currentEval.merge(eval);
@@ -500,6 +591,13 @@ void UciEngine::parseInfo(const QStringRef& line)
 		emit thinking(eval);
 }
 
+bool UciEngine::hasLiveEvalReceivers() const
+{
+	static const QMetaMethod thinkingSignal =
+		QMetaMethod::fromSignal(&ChessPlayer::thinking);
+	return isSignalConnected(thinkingSignal);
+}
+
 EngineOption* UciEngine::parseOption(const QStringRef& line)
 {
 	enum Keyword
@@ -587,15 +685,29 @@ EngineOption* UciEngine::parseOption(const QStringRef& line)
 	return nullptr;
 }
 
+void UciEngine::parseLine(const char* line, int length)
+{
+	// Info lines are by far the most frequent messages, so they
+	// are parsed in place without converting them to a QString
+	const EngineToken command(EngineToken::first(line, length));
+	if (command == "info")
+	{
+		if (!m_ignoreThinking)
+			parseInfo(command);
+		return;
+	}
+
+	parseLine(QString::fromUtf8(line, length));
+}
+
 void UciEngine::parseLine(const QString& line)
 {
 	const QStringRef command(firstToken(line));
 
 	if (command == "info")
 	{
-		if (m_ignoreThinking)
-			return;
-		parseInfo(command);
+		const QByteArray bytes(line.toUtf8());
+		parseLine(bytes.constData(), bytes.size());
 	}
 	else if (command == "bestmove")
 	{
@@ -609,7 +721,7 @@ void UciEngine::parseLine(const QString& line)
 				// TODO: use qAsConst() from Qt 5.7
 				const auto buf = m_bmBuffer;
 				for (const auto& l : buf)
-					write(l, Unbuffered);
+					writeLine(l.constData(), l.size(), Unbuffered);
 				m_bmBuffer.clear();
 			}
 			else
@@ -622,7 +734,7 @@ void UciEngine::parseLine(const QString& line)
 				 qUtf8Printable(name()));
 			m_ponderMove = Chess::Move();
 			m_ponderMoveSan.clear();
-			m_moveStrings.truncate(m_moveStrings.lastIndexOf(' '));
+			removePositionMove();
 			pong();
 			return;
 		}
@@ -638,7 +750,7 @@ void UciEngine::parseLine(const QString& line)
 
 		QStringRef token(nextToken(command));
 		QString moveString(token.toString());
-		m_moveStrings += " " + moveString;
+		addPositionMove(moveString);
 		Chess::Move move = board()->moveFromString(moveString);
 		if (move.isNull())
 		{
@@ -795,47 +907,62 @@ void UciEngine::setPonderMove(const QString& moveString)
 	}
 }
 
-QString UciEngine::directPv(const QVarLengthArray<QStringRef>& tokens)
+QString UciEngine::directPv(const QVarLengthArray<EngineToken>& tokens)
 {
 	QString pv;
 	for( auto token : tokens)
 	{
 		pv += " ";
-		pv += token.toString();
+		pv += QLatin1String(token.data(), token.size());
 	}
 	return pv;
 }
 
-QString UciEngine::sanPv(const QVarLengthArray<QStringRef>& tokens)
+QString UciEngine::coordinatePv(const QVarLengthArray<EngineToken>& tokens)
 {
-	Chess::Board* board = this->board();
 	QString pv;
-	int movesMade = 0;
+	for (int i = 0; i < tokens.size(); i++)
+	{
+		if (i > 0)
+			pv += QLatin1Char(' ');
+		pv += QLatin1String(tokens.at(i).data(), tokens.at(i).size());
+	}
+	return pv;
+}
+
+QString UciEngine::sanPv(const QString& pv)
+{
+	Chess::Board* board = this->board();
+	QVector<Chess::Move> moves;
+	bool ponderMoveMade = false;
 
 	if (pondering() && !m_ponderMove.isNull())
 	{
 		board->makeMove(m_ponderMove);
-		movesMade++;
+		ponderMoveMade = true;
 	}
 
-	for (auto token : tokens)
+	const auto tokens = pv.split(QLatin1Char(' '), QString::SkipEmptyParts);
+	for (const auto& token : tokens)
 	{
-		auto move = board->moveFromString(token.toString());
+		auto move = board->moveFromString(token);
 		if (move.isNull())
 		{
 			qWarning("Illegal PV move %s from %s",
-				 qUtf8Printable(token.toString()),
+				 qUtf8Printable(token),
 				 qUtf8Printable(name()));
 			break;
 		}
-		if (!pv.isEmpty())
-			pv += " ";
-		pv += board->moveString(move, Chess::Board::StandardAlgebraic);
+		moves.append(move);
 		board->makeMove(move);
-		movesMade++;
 	}
 
-	for (int i = 0; i < movesMade; i++)
+	for (int i = 0; i < moves.size(); i++)
+		board->undoMove();
+
+	QString pv(board->moveSequenceString(moves,
+					     Chess::Board::StandardAlgebraic));
+	if (ponderMoveMade)
 		board->undoMove();
 
 	return pv;
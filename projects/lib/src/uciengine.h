@@ -20,6 +20,7 @@
 
 #include "chessengine.h"
 #include <QVarLengthArray>
+#include "enginetoken.h"
 
 
 /*!
@@ -52,6 +53,7 @@ class LIB_EXPORT UciEngine : public ChessEngine
 		virtual void startGame();
 		virtual void startThinking();
 		virtual void parseLine(const QString& line);
+		virtual void parseLine(const char* line, int length);
 		virtual void sendOption(const QString& name, const QVariant& value);
 		virtual bool isPondering() const;
 		
@@ -68,26 +70,41 @@ class LIB_EXPORT UciEngine : public ChessEngine
 						 int typeCount,
 						 QVarLengthArray<QStringRef>& tokens,
 						 int& type);
-		void parseInfo(const QVarLengthArray<QStringRef>& tokens,
+		static EngineToken parseUciTokens(const EngineToken& first,
+						  const char* const* types,
+						  int typeCount,
+						  QVarLengthArray<EngineToken>& tokens,
+						  int& type);
+		void parseInfo(const QVarLengthArray<EngineToken>& tokens,
 			       int type,
 			       MoveEvaluation* eval);
-		void parseInfo(const QStringRef& line);
+		void parseInfo(const EngineToken& command);
 		EngineOption* parseOption(const QStringRef& line);
 		void addVariantsFromOption(const EngineOption* option);
 		void setVariant(const QString& variant);
-		QString positionString();
+		QByteArray positionCommand();
 		void sendPosition();
+		void addPositionMove(const QString& moveString);
+		void removePositionMove();
 		void setPonderMove(const QString& moveString);
-		QString directPv(const QVarLengthArray<QStringRef>& tokens);
-		QString sanPv(const QVarLengthArray<QStringRef>& tokens);
+		QString directPv(const QVarLengthArray<EngineToken>& tokens);
+		QString coordinatePv(const QVarLengthArray<EngineToken>& tokens);
+		QString sanPv(const QString& pv);
+		bool hasLiveEvalReceivers() const;
 		
 		QString m_variantOption;
-		QString m_startFen;
-		QString m_moveStrings;
+		// The current "position" command, with a moves list that
+		// grows and shrinks in place
+		QByteArray m_position;
+		// Length of m_position without the moves
+		int m_positionBase;
+		// Length of m_position the engine was last sent, or zero if
+		// it must be sent the whole command
+		int m_positionSent;
 		bool m_useDirectPv;
 		// Write buffer for messages that will be flushed to the engine
 		// after it sends a "bestmove"
-		QStringList m_bmBuffer;
+		QList<QByteArray> m_bmBuffer;
 		bool m_sendOpponentsName;
 		bool m_canPonder;
 		PonderState m_ponderState;
@@ -60,6 +60,11 @@ QString variantToXboard(const QString& str)
 	return str;
 }
 
+bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
 const int s_infiniteSec = 86400;
 
 } // anonymous namespace
@@ -563,6 +568,67 @@ int XboardEngine::adaptScore(int score) const
 	return score;
 }
 
+void XboardEngine::parseThinking(const EngineToken& depth)
+{
+	bool ok = false;
+	int val = 0;
+	EngineToken token(depth);
+
+	// Search depth
+	if (token.size() > 1 && !isDigit(token.at(token.size() - 1)))
+		token = token.left(token.size() - 1);
+	m_eval.setDepth(token.toInt());
+
+	// Evaluation
+	if ((token = token.next()).isNull())
+		return;
+	val = token.toInt(&ok);
+	if (ok)
+	{
+		if (whiteEvalPov() && side() == Chess::Side::Black)
+			val = -val;
+		m_eval.setScore(adaptScore(val));
+	}
+
+	// Search time
+	if ((token = token.next()).isNull())
+		return;
+	val = token.toInt(&ok);
+	if (ok)
+		m_eval.setTime(val * 10);
+
+	// Node count
+	if ((token = token.next()).isNull())
+		return;
+	quint64 nodes = token.toULongLong(&ok);
+	if (ok)
+		m_eval.setNodeCount(nodes);
+
+	// Principal variation
+	if ((token = token.next(true)).isNull())
+		return;
+	m_eval.setPv(token.toString());
+
+	emit thinking(m_eval);
+}
+
+void XboardEngine::parseLine(const char* line, int length)
+{
+	// Thinking output is by far the most frequent message, so it's
+	// parsed in place without converting the line to a QString
+	const EngineToken command(EngineToken::first(line, length));
+	if (!command.isNull()
+	&&  isDigit(command.at(0))
+	&&  !command.contains('.')
+	&&  command != "1-0" && command != "0-1" && command != "1/2-1/2")
+	{
+		parseThinking(command);
+		return;
+	}
+
+	parseLine(QString::fromUtf8(line, length));
+}
+
 void XboardEngine::parseLine(const QString& line)
 {
 	const QStringRef command(firstToken(line));
@@ -612,48 +678,9 @@ void XboardEngine::parseLine(const QString& line)
 	else if (command.at(0).isDigit()
 	     && !command.contains("."))	// principal variation
 	{
-		bool ok = false;
-		int val = 0;
-		QStringRef ref(command);
-		
-		// Search depth
-		QString depth(ref.toString());
-		if (!(depth.cend() - 1)->isDigit())
-			depth.chop(1);
-		m_eval.setDepth(depth.toInt());
-
-		// Evaluation
-		if ((ref = nextToken(ref)).isNull())
-			return;
-		val = ref.toString().toInt(&ok);
-		if (ok)
-		{
-			if (whiteEvalPov() && side() == Chess::Side::Black)
-				val = -val;
-			m_eval.setScore(adaptScore(val));
-		}
-
-		// Search time
-		if ((ref = nextToken(ref)).isNull())
-			return;
-		val = ref.toString().toInt(&ok);
-		if (ok)
-			m_eval.setTime(val * 10);
-
-		// Node count
-		if ((ref = nextToken(ref)).isNull())
-			return;
-		val = ref.toString().toULongLong(&ok);
-		if (ok)
-			m_eval.setNodeCount(val);
-
-		// Principal variation
-		if ((ref = nextToken(ref, true)).isNull())
-			return;
-		m_eval.setPv(ref.toString());
-
-		emit thinking(m_eval);
-
+		const QByteArray bytes(line.toUtf8());
+		parseThinking(EngineToken::first(bytes.constData(),
+						 bytes.size()));
 		return;
 	}
 
@@ -20,6 +20,7 @@
 
 #include "chessengine.h"
 #include "board/board.h"
+#include "enginetoken.h"
 
 /*!
  * \brief A chess engine which uses the Xboard chess engine communication protocol.
@@ -48,6 +49,7 @@ class LIB_EXPORT XboardEngine : public ChessEngine
 		virtual void startGame();
 		virtual void startThinking();
 		virtual void parseLine(const QString& line);
+		virtual void parseLine(const char* line, int length);
 		virtual void sendOption(const QString& name, const QVariant& value);
 		virtual bool restartsBetweenGames() const;
 
@@ -67,6 +69,7 @@ class LIB_EXPORT XboardEngine : public ChessEngine
 		void finishGame();
 		QString moveString(const Chess::Move& move);
 		int adaptScore(int score) const;
+		void parseThinking(const EngineToken& depth);
 		
 		bool m_forceMode;
 		bool m_drawOnNextMove;
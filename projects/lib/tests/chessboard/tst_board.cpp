@@ -17,6 +17,9 @@ class tst_Board: public QObject
 		
 		void moveStrings_data() const;
 		void moveStrings();
+
+		void sanMoves_data() const;
+		void sanMoves();
 		
 		void results_data() const;
 		void results();
@@ -55,14 +58,14 @@ void tst_Board::setVariant(const QString& variant)
 static quint64 perftVal(Chess::Board* board, int depth)
 {
 	quint64 nodeCount = 0;
-	QVector<Chess::Move> moves(board->legalMoves());
+	Chess::MoveList moves;
+	board->legalMoves(moves);
 	if (depth == 1 || moves.size() == 0)
 		return moves.size();
 
-	QVector<Chess::Move>::const_iterator it;
-	for (it = moves.begin(); it != moves.end(); ++it)
+	for (const Chess::Move& move : moves)
 	{
-		board->makeMove(*it);
+		board->makeMove(move);
 		nodeCount += perftVal(board, depth - 1);
 		board->undoMove();
 	}
@@ -172,6 +175,11 @@ void tst_Board::moveStrings_data() const
 		   "cxd8=N Qxc1 Bxc6 Qxd1 Nxb7 Qxf1+ Kxf1 Bxa2 Rxa2 Kc7"
 		<< "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
 		<< "5bnr/1Nk1pppp/p1B5/8/8/5N2/RPP2PPP/1N3K2 w - - 1 13";
+	QTest::newRow("san capture checker")
+		<< "standard"
+		<< "Nxd2"
+		<< "4k3/8/8/8/8/5N2/3q4/4K3 w - - 0 1"
+		<< "4k3/8/8/8/8/8/3N4/4K3 b - - 0 1";
 	QTest::newRow("coord1")
 		<< "standard"
 		<< "e2e4 b8c6 e4e5 d7d5 e5d6 c8e6 g1f3 d8d7 f1b5 e8c8 d6c7 "
@@ -457,10 +465,20 @@ void tst_Board::moveStrings()
 	QVERIFY(m_board->setFenString(startfen));
 
 	const auto moveList = moves.split(' ', QString::SkipEmptyParts);
+	QVector<Chess::Move> sequence;
+	QStringList sanList;
 	for (const auto& moveStr : moveList)
 	{
 		Chess::Move move = m_board->moveFromString(moveStr);
 		QVERIFY(m_board->isLegalMove(move));
+		const QByteArray bytes(moveStr.toLatin1());
+		QCOMPARE(m_board->moveFromString(bytes.constData(), bytes.size()),
+			 move);
+		const quint16 compact = m_board->compactMove(move);
+		QVERIFY(compact != 0);
+		QCOMPARE(m_board->moveFromCompact(compact), move);
+		sequence << move;
+		sanList << m_board->moveString(move, Chess::Board::StandardAlgebraic);
 		m_board->makeMove(move);
 	}
 	QCOMPARE(m_board->fenString(), endfen);
@@ -470,9 +488,108 @@ void tst_Board::moveStrings()
 		for (int i = 0; i < moveList.size(); i++)
 			m_board->undoMove();
 		QCOMPARE(m_board->fenString(), startfen);
+
+		QString san(m_board->moveSequenceString(sequence,
+				Chess::Board::StandardAlgebraic));
+		QCOMPARE(san, sanList.join(' '));
+		QCOMPARE(m_board->fenString(), startfen);
 	}
 	else
 		QCOMPARE(m_board->fenString(), endfen);
+
+	// Byte FEN strings and packed positions must round-trip
+	char fen[512];
+	int length = m_board->fenString(fen, sizeof(fen));
+	QVERIFY(length > 0);
+	QCOMPARE(QString::fromLatin1(fen, length), m_board->fenString());
+	QVERIFY(m_board->setFenString(fen, length));
+	const QString expectedFen(m_board->fenString());
+	const quint64 expectedKey(m_board->key());
+
+	char packed[Chess::Board::MaxPackedPositionSize];
+	length = m_board->packedPosition(packed, sizeof(packed));
+	QVERIFY(length > 0);
+	QVERIFY(m_board->setPackedPosition(packed, length));
+	QCOMPARE(m_board->fenString(), expectedFen);
+	QCOMPARE(m_board->key(), expectedKey);
+}
+
+void tst_Board::sanMoves_data() const
+{
+	QTest::addColumn<QString>("variant");
+	QTest::addColumn<QString>("fen");
+	QTest::addColumn<QString>("san");
+	QTest::addColumn<QString>("lan");
+
+	QString variant = "standard";
+	QString fen = "4k3/8/8/8/8/5N2/8/1N2K3 w - - 0 1";
+
+	QTest::newRow("ambiguous") << variant << fen << "Nd2" << "";
+	QTest::newRow("file disambiguation") << variant << fen << "Nbd2" << "b1d2";
+	QTest::newRow("rank disambiguation") << variant << fen << "N1d2" << "b1d2";
+	QTest::newRow("other knight") << variant << fen << "Nfd2" << "f3d2";
+	QTest::newRow("false capture") << variant << fen << "Nbxd2" << "";
+
+	fen = "4k3/8/8/8/8/5N2/3p4/4K3 w - - 0 1";
+	QTest::newRow("capture") << variant << fen << "Nxd2" << "f3d2";
+	QTest::newRow("missing capture") << variant << fen << "Nd2" << "";
+
+	fen = "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1";
+	QTest::newRow("en passant") << variant << fen << "exd6" << "e5d6";
+	QTest::newRow("en passant no capture")
+		<< variant << fen << "ed6" << "";
+	QTest::newRow("no en passant")
+		<< variant << "4k3/8/8/3pP3/8/8/8/4K3 w - - 0 1"
+		<< "exd6" << "";
+
+	fen = "8/4P3/8/8/8/8/k7/4K3 w - - 0 1";
+	QTest::newRow("promotion") << variant << fen << "e8=Q" << "e7e8q";
+	QTest::newRow("promotion no =") << variant << fen << "e8Q" << "e7e8q";
+	QTest::newRow("missing promotion") << variant << fen << "e8" << "";
+
+	QTest::newRow("pinned")
+		<< variant << "4k3/4r3/8/8/8/8/4N3/4K3 w - - 0 1"
+		<< "Nc3" << "";
+	QTest::newRow("pinned candidate")
+		<< variant << "4k3/4r3/8/8/8/8/4N3/1N2K3 w - - 0 1"
+		<< "Nc3" << "b1c3";
+
+	variant = "fischerandom";
+	fen = "4k3/8/8/8/8/8/8/1R2K1R1 w GB - 0 1";
+	QTest::newRow("frc O-O") << variant << fen << "O-O" << "e1g1";
+	QTest::newRow("frc O-O-O") << variant << fen << "O-O-O" << "e1b1";
+	QTest::newRow("frc O-O attacked")
+		<< variant << "1rk3r1/8/8/8/8/8/8/1RK1R3 w EBgb - 0 1"
+		<< "O-O" << "";
+}
+
+void tst_Board::sanMoves()
+{
+	QFETCH(QString, variant);
+	QFETCH(QString, fen);
+	QFETCH(QString, san);
+	QFETCH(QString, lan);
+
+	setVariant(variant);
+	QVERIFY(m_board->setFenString(fen));
+
+	Chess::Move move = m_board->moveFromString(san);
+	const QByteArray bytes(san.toLatin1());
+	QCOMPARE(m_board->moveFromString(bytes.constData(), bytes.size()),
+		 move);
+
+	// Cached legal moves must give the same answer
+	m_board->cacheLegalMoves();
+	QCOMPARE(m_board->moveFromString(san), move);
+
+	if (lan.isEmpty())
+		QVERIFY(move.isNull());
+	else
+	{
+		QVERIFY(m_board->isLegalMove(move));
+		QCOMPARE(m_board->moveString(move, Chess::Board::LongAlgebraic),
+			 lan);
+	}
 }
 
 void tst_Board::results_data() const
@@ -782,6 +899,11 @@ void tst_Board::perft_data() const
 		<< "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -"
 		<< 6
 		<< Q_UINT64_C(11030083);
+	QTest::newRow("capture checker")
+		<< variant
+		<< "4k3/8/8/8/8/5N2/3q4/4K3 w - - 0 1"
+		<< 1
+		<< Q_UINT64_C(3);
 
 	variant = "capablanca";
 	QTest::newRow("gothic startpos")
@@ -0,0 +1,4 @@
+include(../tests.pri)
+
+TARGET = tst_engineprocess
+SOURCES += tst_engineprocess.cpp
@@ -0,0 +1,150 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <engineprocess.h>
+
+
+class tst_EngineProcess: public QObject
+{
+	Q_OBJECT
+
+	private slots:
+		void initTestCase();
+
+		void readUntilEof();
+		void workingDirectory();
+		void programInWorkingDirectory();
+		void missingProgram();
+		void standardErrorFile();
+		void exitCode();
+		void crashExit();
+
+	private:
+		QByteArray readAll(EngineProcess& process);
+		QByteArray readFile(const QString& fileName);
+
+		QTemporaryDir m_dir;
+};
+
+
+void tst_EngineProcess::initTestCase()
+{
+	QVERIFY(m_dir.isValid());
+}
+
+QByteArray tst_EngineProcess::readAll(EngineProcess& process)
+{
+	QSignalSpy spy(&process, SIGNAL(readChannelFinished()));
+	if (!spy.wait(5000))
+		return QByteArray();
+	return process.readAll();
+}
+
+QByteArray tst_EngineProcess::readFile(const QString& fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return QByteArray();
+	return file.readAll();
+}
+
+void tst_EngineProcess::readUntilEof()
+{
+	EngineProcess process;
+	process.start("sh", QStringList() << "-c" << "read x; echo got $x");
+	QVERIFY(process.waitForStarted());
+	process.write("line\n");
+
+	QCOMPARE(readAll(process), QByteArray("got line\n"));
+	QVERIFY(process.waitForFinished());
+	QCOMPARE(process.exitCode(), 0);
+	QCOMPARE(process.exitStatus(), EngineProcess::NormalExit);
+}
+
+void tst_EngineProcess::workingDirectory()
+{
+	EngineProcess process;
+	process.setWorkingDirectory(m_dir.path());
+	process.start("pwd");
+	QVERIFY(process.waitForStarted());
+
+	const QString dir(QString::fromLocal8Bit(readAll(process)).trimmed());
+	QCOMPARE(QDir(dir).canonicalPath(), QDir(m_dir.path()).canonicalPath());
+	QVERIFY(process.waitForFinished());
+}
+
+void tst_EngineProcess::programInWorkingDirectory()
+{
+	const QString name("tst_engineprocess_engine");
+	QFile script(m_dir.filePath(name));
+	QVERIFY(script.open(QIODevice::WriteOnly));
+	script.write("#!/bin/sh\necho engine \"$@\"\n");
+	script.close();
+	QVERIFY(script.setPermissions(script.permissions()
+				      | QFile::ExeOwner));
+
+	EngineProcess process;
+	process.setWorkingDirectory(m_dir.path());
+	process.start(name, QStringList() << "arg");
+	QVERIFY(process.waitForStarted());
+
+	QCOMPARE(readAll(process), QByteArray("engine arg\n"));
+	QVERIFY(process.waitForFinished());
+	QCOMPARE(process.exitCode(), 0);
+}
+
+void tst_EngineProcess::missingProgram()
+{
+	EngineProcess process;
+	process.setWorkingDirectory(m_dir.path());
+	process.start("tst_engineprocess_missing");
+	QVERIFY(!process.waitForStarted());
+	QVERIFY(!process.isOpen());
+}
+
+void tst_EngineProcess::standardErrorFile()
+{
+	const QString fileName(m_dir.filePath("stderr.txt"));
+	const QStringList args(QStringList() << "-c" << "echo error >&2");
+
+	for (int i = 0; i < 2; i++)
+	{
+		EngineProcess process;
+		process.setStandardErrorFile(fileName, QIODevice::Append);
+		process.start("sh", args);
+		QVERIFY(process.waitForStarted());
+		QVERIFY(process.waitForFinished());
+	}
+	QCOMPARE(readFile(fileName), QByteArray("error\nerror\n"));
+
+	EngineProcess process;
+	process.setStandardErrorFile(fileName);
+	process.start("sh", args);
+	QVERIFY(process.waitForStarted());
+	QVERIFY(process.waitForFinished());
+	QCOMPARE(readFile(fileName), QByteArray("error\n"));
+}
+
+void tst_EngineProcess::exitCode()
+{
+	EngineProcess process;
+	process.start("sh", QStringList() << "-c" << "exit 3");
+	QVERIFY(process.waitForStarted());
+	QVERIFY(process.waitForFinished());
+	QCOMPARE(process.exitCode(), 3);
+	QCOMPARE(process.exitStatus(), EngineProcess::NormalExit);
+}
+
+void tst_EngineProcess::crashExit()
+{
+	EngineProcess process;
+	process.start("sleep", QStringList() << "10");
+	QVERIFY(process.waitForStarted());
+
+	process.kill();
+	QVERIFY(process.waitForFinished());
+	QCOMPARE(process.exitStatus(), EngineProcess::CrashExit);
+}
+
+QTEST_MAIN(tst_EngineProcess)
+#include "tst_engineprocess.moc"
@@ -1,4 +1,5 @@
 include(../tests.pri)
 
+QT += concurrent
 TARGET = tst_tb
 SOURCES += tst_tb.cpp
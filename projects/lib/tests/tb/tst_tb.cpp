@@ -1,7 +1,63 @@
 #include <QtTest/QtTest>
+#include <QtConcurrentRun>
 #include <board/standardboard.h>
 #include <board/syzygytablebase.h>
 
+namespace {
+
+struct TbPosition
+{
+	const char* name;
+	const char* fen;
+	const char* result;
+	int dtz;
+};
+
+const TbPosition s_positions[] =
+{
+	{ "startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "*", 0 },
+	{ "pos2", "7k/8/8/8/5KP1/8/8/8 w - - 0 1", "1-0", 7 },
+	{ "pos3", "7k/8/8/6P1/5K2/8/8/8 w - - 0 1", "1/2-1/2", 0 },
+	{ "pos4", "8/2k5/8/6N1/5K2/1r6/8/8 w - - 0 1", "1/2-1/2", 0 },
+	{ "pos5", "1n6/8/8/8/8/8/6R1/2K1k3 w - - 0 1", "1-0", 48 },
+	{ "pos6", "3n4/8/8/8/7R/8/8/2K1k3 w - - 0 1", "1-0", 48 },
+	{ "pos7", "8/8/3n4/8/8/8/4R3/2K2k2 w - - 0 1", "1-0", 44 },
+	{ "pos8", "8/8/7R/n7/8/8/8/2K2k2 w - - 0 1", "1-0", 44 },
+	{ "pos9", "4n3/8/8/8/7R/8/8/3K1k2 w - - 0 1", "1-0", 46 },
+	{ "pos10", "2B5/8/8/8/8/2K2k2/6p1/8 b - - 0 1", "0-1", 1 },
+	{ "pos11", "8/B7/8/8/8/2K2k2/6p1/8 b - - 0 1", "1/2-1/2", 0 },
+	{ "pos12", "2K4N/8/8/8/7p/5k2/8/8 w - - 0 1", "0-1", 4 },
+	{ "pos13", "K5Q1/8/8/8/5bb1/6k1/8/8 b - - 0 72", "1/2-1/2", 124 },	// TCEC9 superfinal game 17.
+};
+
+/*
+ * Probes every position in s_positions \a rounds times on a private
+ * board, starting from \a offset so that concurrent callers hit
+ * different tables first. Returns the number of wrong answers.
+ */
+int probePositions(int offset, int rounds)
+{
+	const int count = int(sizeof(s_positions) / sizeof(s_positions[0]));
+	Chess::StandardBoard board;
+	board.initialize();
+	int errors = 0;
+
+	for (int i = 0; i < rounds * count; i++)
+	{
+		const TbPosition& pos = s_positions[(offset + i) % count];
+		if (!board.setFenString(pos.fen))
+			return -1;
+
+		unsigned int dtz = 0;
+		if (board.tablebaseResult(&dtz).toShortString() != pos.result
+		||  int(dtz) != pos.dtz)
+			errors++;
+	}
+
+	return errors;
+}
+
+} // anonymous namespace
 
 class tst_Tb: public QObject
 {
@@ -12,8 +68,13 @@ class tst_Tb: public QObject
 		
 		void tbInitialized();
 		
+		void concurrentProbes();
+		
 		void positions_data() const;
 		void positions();
+		void wdlPositions_data() const;
+		void wdlPositions();
+		void materialStatistics();
 		
 		void cleanupTestCase();
 		
@@ -39,64 +100,33 @@ void tst_Tb::tbInitialized()
 	         "4-piece tablebases unavailable");
 }
 
+void tst_Tb::concurrentProbes()
+{
+	const int threadCount = qMax(8, QThread::idealThreadCount() * 2);
+	QThreadPool pool;
+	pool.setMaxThreadCount(threadCount);
+
+	QVector< QFuture<int> > futures;
+	for (int i = 0; i < threadCount; i++)
+		futures << QtConcurrent::run(&pool, probePositions, i, 20);
+
+	for (QFuture<int>& future : futures)
+		QCOMPARE(future.result(), 0);
+}
+
 void tst_Tb::positions_data() const
 {
 	QTest::addColumn<QString>("fen");
 	QTest::addColumn<QString>("result");
 	QTest::addColumn<int>("dtz");
 	
-	QTest::newRow("startpos")
-		<< "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
-		<< "*"
-		<< 0;
-	QTest::newRow("pos2")
-		<< "7k/8/8/8/5KP1/8/8/8 w - - 0 1"
-		<< "1-0"
-		<< 7;
-	QTest::newRow("pos3")
-		<< "7k/8/8/6P1/5K2/8/8/8 w - - 0 1"
-		<< "1/2-1/2"
-		<< 0;
-	QTest::newRow("pos4")
-		<< "8/2k5/8/6N1/5K2/1r6/8/8 w - - 0 1"
-		<< "1/2-1/2"
-		<< 0;
-	QTest::newRow("pos5")
-		<< "1n6/8/8/8/8/8/6R1/2K1k3 w - - 0 1"
-		<< "1-0"
-		<< 48;
-	QTest::newRow("pos6")
-		<< "3n4/8/8/8/7R/8/8/2K1k3 w - - 0 1"
-		<< "1-0"
-		<< 48;
-	QTest::newRow("pos7")
-		<< "8/8/3n4/8/8/8/4R3/2K2k2 w - - 0 1"
-		<< "1-0"
-		<< 44;
-	QTest::newRow("pos8")
-		<< "8/8/7R/n7/8/8/8/2K2k2 w - - 0 1"
-		<< "1-0"
-		<< 44;
-	QTest::newRow("pos9")
-		<< "4n3/8/8/8/7R/8/8/3K1k2 w - - 0 1"
-		<< "1-0"
-		<< 46;
-	QTest::newRow("pos10")
-		<< "2B5/8/8/8/8/2K2k2/6p1/8 b - - 0 1"
-		<< "0-1"
-		<< 1;
-	QTest::newRow("pos11")
-		<< "8/B7/8/8/8/2K2k2/6p1/8 b - - 0 1"
-		<< "1/2-1/2"
-		<< 0;
-	QTest::newRow("pos12")
-		<< "2K4N/8/8/8/7p/5k2/8/8 w - - 0 1"
-		<< "0-1"
-		<< 4;
-	QTest::newRow("pos13")	// TCEC9 superfinal game 17.
-		<< "K5Q1/8/8/8/5bb1/6k1/8/8 b - - 0 72"
-		<< "1/2-1/2"
-		<< 124;
+	for (const TbPosition& pos : s_positions)
+	{
+		QTest::newRow(pos.name)
+			<< QString(pos.fen)
+			<< QString(pos.result)
+			<< pos.dtz;
+	}
 }
 
 void tst_Tb::positions()
@@ -112,5 +142,39 @@ void tst_Tb::positions()
 	QCOMPARE(int(tbDtz), dtz);
 }
 
+void tst_Tb::wdlPositions_data() const
+{
+	positions_data();
+}
+
+void tst_Tb::wdlPositions()
+{
+	QFETCH(QString, fen);
+	QFETCH(QString, result);
+
+	QVERIFY(m_board.setFenString(fen));
+	QCOMPARE(m_board.tablebaseWdlResult().toShortString(), result);
+
+	// The second probe of the same position comes from the cache
+	const quint64 hits = SyzygyTablebase::cacheHitCount();
+	QCOMPARE(m_board.tablebaseWdlResult().toShortString(), result);
+	if (m_board.reversibleMoveCount() == 0 && result != "*")
+		QCOMPARE(SyzygyTablebase::cacheHitCount(), hits + 1);
+}
+
+void tst_Tb::materialStatistics()
+{
+	// "pos5" has been probed by the previous tests
+	const auto stats = SyzygyTablebase::materialStatistics();
+	auto it = std::find_if(stats.begin(), stats.end(),
+		[](const SyzygyTablebase::MaterialStatistics& item)
+		{ return item.material == "KRvKN"; });
+
+	QVERIFY(it != stats.end());
+	QVERIFY(it->hits > 0);
+	QCOMPARE(it->misses, quint64(0));
+	QVERIFY(it->probeTime > 0);
+}
+
 QTEST_MAIN(tst_Tb)
 #include "tst_tb.moc"
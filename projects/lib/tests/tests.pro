@@ -3,3 +3,6 @@ SUBDIRS = chessboard tb sprt mersenne tournamentplayer tournamentpair polyglotbo
 win32 {
     SUBDIRS += pipereader
 }
+linux {
+    SUBDIRS += engineprocess
+}